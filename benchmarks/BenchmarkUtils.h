@@ -0,0 +1,93 @@
+// BenchmarkUtils.h
+#ifndef BENCHMARKUTILS_H
+#define BENCHMARKUTILS_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <cstdio>
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Summary statistics of a set of latency samples.
+ */
+struct LatencySummary {
+    size_t count = 0;   ///< Number of samples.
+    double mean = 0.0;  ///< Mean in microseconds.
+    double min = 0.0;   ///< Minimum in microseconds.
+    double p50 = 0.0;   ///< Median in microseconds.
+    double p99 = 0.0;   ///< 99th percentile in microseconds.
+    double max = 0.0;   ///< Maximum in microseconds.
+};
+
+/**
+ * @brief Computes summary statistics of latency samples.
+ * @param samplesUs Samples in microseconds (sorted in place).
+ * @return The summary statistics.
+ */
+inline LatencySummary summarizeLatencies(std::vector<double>& samplesUs) {
+    LatencySummary summary;
+    if (samplesUs.empty()) {
+        return summary;
+    }
+
+    std::sort(samplesUs.begin(), samplesUs.end());
+    summary.count = samplesUs.size();
+    summary.mean = std::accumulate(samplesUs.begin(), samplesUs.end(), 0.0) / samplesUs.size();
+    summary.min = samplesUs.front();
+    summary.p50 = samplesUs[samplesUs.size() / 2];
+    summary.p99 = samplesUs[std::min(samplesUs.size() - 1, samplesUs.size() * 99 / 100)];
+    summary.max = samplesUs.back();
+    return summary;
+}
+
+/**
+ * @brief Times a function over a number of iterations.
+ * @tparam Function Callable taking no arguments.
+ * @param iterations Number of timed calls.
+ * @param function The function to time.
+ * @return Latency of every call in microseconds.
+ */
+template <typename Function>
+std::vector<double> timeIterations(int iterations, Function function) {
+    std::vector<double> samplesUs;
+    samplesUs.reserve(iterations);
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        samplesUs.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return samplesUs;
+}
+
+/**
+ * @brief Prints the header of a latency table.
+ */
+inline void printLatencyHeader() {
+    std::printf("%-40s %10s %10s %10s %10s %10s %10s\n", "benchmark", "count", "mean_us", "min_us", "p50_us", "p99_us", "max_us");
+}
+
+/**
+ * @brief Prints one row of a latency table.
+ * @param name Name of the benchmark.
+ * @param summary The summary statistics to print.
+ */
+inline void printLatencyRow(const std::string& name, const LatencySummary& summary) {
+    std::printf("%-40s %10zu %10.2f %10.2f %10.2f %10.2f %10.2f\n", name.c_str(), summary.count,
+                summary.mean, summary.min, summary.p50, summary.p99, summary.max);
+}
+
+/**
+ * @brief Converts latency statistics into a JSON object for machine-readable results.
+ * @param summary The summary statistics.
+ * @return Object with the count and the statistics in microseconds.
+ */
+inline nlohmann::json latencySummaryToJson(const LatencySummary& summary) {
+    return {{"count", summary.count}, {"mean_us", summary.mean}, {"min_us", summary.min},
+            {"p50_us", summary.p50}, {"p99_us", summary.p99}, {"max_us", summary.max}};
+}
+
+#endif // BENCHMARKUTILS_H
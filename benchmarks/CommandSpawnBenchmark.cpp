@@ -0,0 +1,68 @@
+/**
+ * @file CommandSpawnBenchmark.cpp
+ * @brief Compares the latency of the ways CommandRunner can run a command.
+ *
+ * Usage: command_spawn_benchmark [iterations]
+ */
+
+#include "CommandRunner.h"
+#include "BenchmarkUtils.h"
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+const int DEFAULT_ITERATIONS = 500;
+
+/**
+ * @brief Runs a command the way CommandRunner::execute() used to, with popen and 128 byte fgets reads.
+ * @param command The command line to run.
+ * @return The output of the command.
+ */
+std::string executeWithPopen(const std::string& command) {
+    std::string output;
+    std::array<char, 128> buffer;
+    std::shared_ptr<FILE> pipe(popen(command.c_str(), "r"), pclose);
+    while (!feof(pipe.get())) {
+        if (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
+            output += buffer.data();
+        }
+    }
+    return output;
+}
+
+/**
+ * @brief Times one command through popen, the shell spawn path and the direct spawn path.
+ * @param label Label for the rows of the table.
+ * @param arguments The command and its arguments.
+ * @param iterations Number of timed runs per path.
+ */
+void benchmarkCommand(const std::string& label, const std::vector<std::string>& arguments, int iterations) {
+    CommandRunner shellRunner(arguments, true);
+    CommandRunner directRunner(arguments, false);
+    std::string commandLine = shellRunner.getCommand();
+
+    // Warm up the page cache and the dynamic loader before timing
+    executeWithPopen(commandLine);
+    shellRunner.execute();
+    directRunner.execute();
+
+    std::vector<double> popenSamples = timeIterations(iterations, [&]() { executeWithPopen(commandLine); });
+    std::vector<double> shellSamples = timeIterations(iterations, [&]() { shellRunner.execute(); });
+    std::vector<double> directSamples = timeIterations(iterations, [&]() { directRunner.execute(); });
+
+    printLatencyRow(label + " popen+fgets", summarizeLatencies(popenSamples));
+    printLatencyRow(label + " spawn /bin/sh -c", summarizeLatencies(shellSamples));
+    printLatencyRow(label + " spawn argv", summarizeLatencies(directSamples));
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = (argc > 1) ? std::stoi(argv[1]) : DEFAULT_ITERATIONS;
+
+    printLatencyHeader();
+    benchmarkCommand("true", {"true"}, iterations);
+    benchmarkCommand("echo", {"echo", "Hello", "World"}, iterations);
+    benchmarkCommand("head 1MiB", {"head", "-c", "1048576", "/dev/zero"}, iterations / 10 + 1);
+
+    return 0;
+}
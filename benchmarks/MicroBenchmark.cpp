@@ -0,0 +1,232 @@
+/**
+ * @file MicroBenchmark.cpp
+ * @brief Measures the per-call cost of the publisher's core components, for comparing runs.
+ *
+ * Covers DataBuffer Push, GetBuffer and SerializeBuffer across buffer depths and entry sizes,
+ * CommandRunner::execute, ProjectPrinter::Print and DataTransmitter::publish over inproc with a
+ * subscriber draining the socket. The table is printed to stdout, the same results are written
+ * as JSON when an output file is given, one object per benchmark with its name, parameters and
+ * latency statistics, so two runs can be compared with any JSON tool.
+ *
+ * Printed lines of ProjectPrinter go to /dev/null so the table stays readable.
+ *
+ * Usage: micro_benchmark [iterations] [results.json]
+ */
+
+#include "DataBuffer.h"
+#include "DataChannel.h"
+#include "DataTransmitter.h"
+#include "DataTransmitterManager.h"
+#include "CommandRunner.h"
+#include "ProjectPrinter.h"
+#include "BenchmarkUtils.h"
+#include <zmq.hpp>
+#include <nlohmann/json.hpp>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int DEFAULT_ITERATIONS = 10000;
+const std::vector<size_t> BUFFER_DEPTHS = {1, 10, 100, 1000};
+const std::vector<size_t> ENTRY_SIZES = {16, 256, 4096};
+const std::vector<size_t> PUBLISH_SIZES = {64, 4096, 65536};
+const size_t BYTES_PER_ITERATION_STEP = 64 * 1024; ///< Larger work per call gets proportionally fewer iterations.
+const std::string TRANSMITTER_ADDRESS = "inproc://micro-benchmark";
+
+/**
+ * @brief Collects the results of all benchmarks for the table and the JSON output.
+ */
+class BenchmarkResults {
+public:
+    /**
+     * @brief Records and prints the result of one benchmark.
+     * @param name Name of the benchmark, shared by all parameter combinations.
+     * @param params Parameters of this run.
+     * @param samplesUs Latency samples in microseconds (sorted in place).
+     */
+    void add(const std::string& name, const nlohmann::json& params, std::vector<double>& samplesUs) {
+        LatencySummary summary = summarizeLatencies(samplesUs);
+        std::string label = name;
+        for (const auto& param : params.items()) {
+            label += " " + param.key() + "=" + param.value().dump();
+        }
+        printLatencyRow(label, summary);
+
+        nlohmann::json result = latencySummaryToJson(summary);
+        result["name"] = name;
+        result["params"] = params;
+        results.push_back(result);
+    }
+
+    /**
+     * @brief Writes all results with a description of the machine.
+     * @param path The file to write.
+     * @param iterations Base number of iterations of the run.
+     * @return True if written, false otherwise.
+     */
+    bool write(const std::string& path, int iterations) const {
+        char hostname[256] = {};
+        gethostname(hostname, sizeof(hostname) - 1);
+        nlohmann::json document = {
+            {"context", {
+                {"timestamp", static_cast<long long>(std::time(nullptr))},
+                {"host", hostname},
+                {"cpus", std::thread::hardware_concurrency()},
+                {"compiler", __VERSION__},
+                {"iterations", iterations}
+            }},
+            {"benchmarks", results}
+        };
+        std::ofstream file(path);
+        file << document.dump(2) << std::endl;
+        return static_cast<bool>(file);
+    }
+
+private:
+    nlohmann::json results = nlohmann::json::array(); ///< One object per benchmark run.
+};
+
+/**
+ * @brief Scales the number of iterations down for calls that handle many bytes.
+ * @param iterations Base number of iterations.
+ * @param bytes Bytes handled per call.
+ * @return Number of iterations, at least 10.
+ */
+int scaledIterations(int iterations, size_t bytes) {
+    size_t steps = bytes / BYTES_PER_ITERATION_STEP + 1;
+    return std::max(10, static_cast<int>(iterations / steps));
+}
+
+/**
+ * @brief Benchmarks the data buffer across depths and entry sizes.
+ * @param iterations Base number of iterations.
+ * @param results Receives the results.
+ * @param checksum Accumulates output sizes so the work is not optimized away.
+ */
+void benchmarkDataBuffer(int iterations, BenchmarkResults& results, size_t& checksum) {
+    for (size_t depth : BUFFER_DEPTHS) {
+        for (size_t entrySize : ENTRY_SIZES) {
+            nlohmann::json params = {{"depth", depth}, {"entry_bytes", entrySize}};
+            std::string entry(entrySize, 'x');
+            int count = scaledIterations(iterations, depth * entrySize);
+
+            // The buffer holds one more slot than entries, keep it full so every call sees the full depth
+            DataBuffer<std::string> buffer(depth + 1);
+            for (size_t i = 0; i < depth; ++i) {
+                buffer.Push(entry);
+            }
+
+            std::vector<double> pushSamples = timeIterations(iterations, [&]() { buffer.Push(entry); });
+            std::vector<double> getSamples = timeIterations(count, [&]() { checksum += buffer.GetBuffer().size(); });
+            std::vector<double> serializeSamples = timeIterations(count, [&]() { checksum += buffer.SerializeBuffer().size(); });
+
+            results.add("DataBuffer::Push", params, pushSamples);
+            results.add("DataBuffer::GetBuffer", params, getSamples);
+            results.add("DataBuffer::SerializeBuffer", params, serializeSamples);
+        }
+    }
+}
+
+/**
+ * @brief Benchmarks running a command through CommandRunner.
+ * @param iterations Base number of iterations, commands run a hundredth of them.
+ * @param results Receives the results.
+ * @param checksum Accumulates output sizes so the work is not optimized away.
+ */
+void benchmarkCommandRunner(int iterations, BenchmarkResults& results, size_t& checksum) {
+    int count = std::max(10, iterations / 100);
+    for (bool useShell : {false, true}) {
+        CommandRunner runner(std::vector<std::string>{"echo", "hello"}, useShell);
+        runner.execute();
+        std::vector<double> samples = timeIterations(count, [&]() { checksum += runner.execute().size(); });
+        results.add("CommandRunner::execute", {{"command", "echo hello"}, {"shell", useShell}}, samples);
+    }
+}
+
+/**
+ * @brief Benchmarks formatting and printing a line through ProjectPrinter.
+ * @param iterations Base number of iterations.
+ * @param results Receives the results.
+ */
+void benchmarkPrinter(int iterations, BenchmarkResults& results) {
+    std::ofstream sink("/dev/null");
+    std::streambuf* terminal = std::cout.rdbuf(sink.rdbuf());
+    ProjectPrinter printer;
+    std::vector<double> printSamples = timeIterations(iterations, [&]() {
+        printer.Print("Published to channel EXAMPLE at address tcp://127.0.0.1:5555");
+    });
+    std::vector<double> warningSamples = timeIterations(iterations, [&]() {
+        printer.PrintWarning("Send queue is full", __LINE__, __FILE__);
+    });
+    std::cout.rdbuf(terminal);
+
+    results.add("ProjectPrinter::Print", nlohmann::json::object(), printSamples);
+    results.add("ProjectPrinter::PrintWarning", {{"line_number", true}}, warningSamples);
+}
+
+/**
+ * @brief Benchmarks publishing a payload through a DataTransmitter over inproc.
+ * @param iterations Base number of iterations.
+ * @param results Receives the results.
+ */
+void benchmarkTransmitter(int iterations, BenchmarkResults& results) {
+    DataTransmitterManager& transmitterManager = DataTransmitterManager::Instance();
+    DataChannel channel("MICRO", 1, 0, TRANSMITTER_ADDRESS);
+    std::shared_ptr<DataTransmitter> transmitter = transmitterManager.getTransmitter(TRANSMITTER_ADDRESS);
+    transmitter->bind();
+
+    // Drain the socket from another thread so sending never hits the high water mark
+    std::atomic<bool> stop(false);
+    std::thread subscriber([&]() {
+        zmq::socket_t socket(transmitterManager.getContext(), ZMQ_SUB);
+        socket.set(zmq::sockopt::subscribe, "");
+        socket.set(zmq::sockopt::rcvtimeo, 100);
+        socket.connect(TRANSMITTER_ADDRESS);
+        zmq::message_t frame;
+        while (!stop) {
+            (void)socket.recv(frame);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Let the subscription arrive
+
+    for (size_t size : PUBLISH_SIZES) {
+        auto payload = std::make_shared<const std::string>(size, 'x');
+        std::vector<double> samples = timeIterations(scaledIterations(iterations, size), [&]() {
+            transmitter->publish(channel, payload);
+        });
+        results.add("DataTransmitter::publish", {{"transport", "inproc"}, {"payload_bytes", size}}, samples);
+    }
+
+    stop = true;
+    subscriber.join();
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = (argc > 1) ? std::stoi(argv[1]) : DEFAULT_ITERATIONS;
+    std::string outputPath = (argc > 2) ? argv[2] : "";
+    BenchmarkResults results;
+    size_t checksum = 0;
+
+    printLatencyHeader();
+    benchmarkDataBuffer(iterations, results, checksum);
+    benchmarkCommandRunner(iterations, results, checksum);
+    benchmarkPrinter(iterations, results);
+    benchmarkTransmitter(iterations, results);
+    std::printf("checksum %zu\n", checksum);
+
+    if (!outputPath.empty()) {
+        if (!results.write(outputPath, iterations)) {
+            std::fprintf(stderr, "Failed to write %s\n", outputPath.c_str());
+            return 1;
+        }
+        std::printf("results written to %s\n", outputPath.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file PrinterBenchmark.cpp
+ * @brief Compares the per-call cost of ProjectPrinter before and after caching its configuration
+ * and with the asynchronous logging backend.
+ *
+ * Printed lines go to the sink file (default /dev/null) so the table on stdout stays readable.
+ * Pass a file on a real disk or /dev/tty to include the cost of slower output.
+ *
+ * Usage: printer_benchmark [iterations] [sink]
+ */
+
+#include "ProjectPrinter.h"
+#include "AsyncLogger.h"
+#include "BenchmarkUtils.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Set by CMake, relative to the repository root otherwise
+#ifndef PRINTER_CONFIG_DIR
+#define PRINTER_CONFIG_DIR "utilities"
+#endif
+
+const int DEFAULT_ITERATIONS = 100000;
+const size_t LOG_BUFFER_LINES = 8192;
+
+/**
+ * @brief Reads and parses printer_config.json the way every ProjectPrinter constructor used to.
+ * @param configPath Path to the printer configuration.
+ * @return The prefix from the configuration, so the work is not optimized away.
+ */
+std::string parseConfigLikeBefore(const std::string& configPath) {
+    nlohmann::json config;
+    std::ifstream configFile(configPath);
+    configFile >> config;
+    return config["prefix"].get<std::string>();
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = (argc > 1) ? std::stoi(argv[1]) : DEFAULT_ITERATIONS;
+    std::string sinkPath = (argc > 2) ? argv[2] : "/dev/null";
+    std::string configPath = std::string(PRINTER_CONFIG_DIR) + "/printer_config.json";
+
+    // Printed lines go to the sink, the results table is printed with printf to stdout
+    std::ofstream sink(sinkPath);
+    std::streambuf* terminal = std::cout.rdbuf(sink.rdbuf());
+
+    // The configuration file is parsed once per process now, warm up the cache
+    ProjectPrinter warmUp;
+    size_t checksum = 0;
+
+    std::vector<double> parseSamples = timeIterations(iterations / 10 + 1, [&]() {
+        checksum += parseConfigLikeBefore(configPath).size();
+    });
+    std::vector<double> constructSamples = timeIterations(iterations, [&]() {
+        ProjectPrinter printer;
+        checksum += printer.shouldPrintTime();
+    });
+    std::vector<double> syncSamples = timeIterations(iterations, [&]() {
+        ProjectPrinter printer;
+        printer.Print("Published to channel EXAMPLE at address tcp://127.0.0.1:5555");
+    });
+
+    AsyncLogger::Instance().start(LOG_BUFFER_LINES);
+    std::vector<double> asyncSamples = timeIterations(iterations, [&]() {
+        ProjectPrinter printer;
+        printer.Print("Published to channel EXAMPLE at address tcp://127.0.0.1:5555");
+    });
+    AsyncLogger::Instance().stop();
+
+    std::cout.rdbuf(terminal);
+
+    printLatencyHeader();
+    printLatencyRow("parse printer_config.json (old ctor)", summarizeLatencies(parseSamples));
+    printLatencyRow("construct (cached config)", summarizeLatencies(constructSamples));
+    printLatencyRow("construct + Print synchronous", summarizeLatencies(syncSamples));
+    printLatencyRow("construct + Print asynchronous", summarizeLatencies(asyncSamples));
+    std::printf("async lines dropped: %llu (checksum %zu)\n",
+                static_cast<unsigned long long>(AsyncLogger::Instance().getDroppedCount()), checksum);
+
+    return 0;
+}
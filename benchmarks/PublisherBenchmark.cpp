@@ -0,0 +1,325 @@
+/**
+ * @file PublisherBenchmark.cpp
+ * @brief Measures the throughput, delivery latency and CPU cost per message of the whole
+ * publishing pipeline over the inproc, ipc and tcp loopback transports.
+ *
+ * Every run configures one data channel through DataChannelManager, fed by a synthetic
+ * processor that produces payloads of a fixed size at a fixed rate, and drives it like the
+ * publisher's main loop does. A subscriber thread in the same process receives the messages and
+ * measures the latency from the header frame's send and processing times, and counts lost
+ * messages by gaps in the sequence numbers. Everything runs on the local machine.
+ *
+ * Usage: publisher_bench [duration-s] [rate] [payload-sizes] [transports] [sender-threads]
+ *   duration-s      Measured time per run (default 2).
+ *   rate            Messages per second, 0 publishes as fast as possible (default 0).
+ *   payload-sizes   Comma separated payload sizes in bytes (default 64,1024,16384).
+ *   transports      Comma separated transports out of inproc, ipc and tcp (default inproc,ipc,tcp).
+ *   sender-threads  1 to send from the transmitters' sender threads (default 0).
+ */
+
+#include "DataChannelManager.h"
+#include "DataTransmitterManager.h"
+#include "GeneralProcessor.h"
+#include "GeneralProcessorFactory.h"
+#include "MessageHeader.h"
+#include "BenchmarkUtils.h"
+#include <zmq.hpp>
+#include <nlohmann/json.hpp>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int DEFAULT_DURATION_S = 2;
+const int DEFAULT_RATE = 0;
+const std::string DEFAULT_PAYLOAD_SIZES = "64,1024,16384";
+const std::string DEFAULT_TRANSPORTS = "inproc,ipc,tcp";
+const int BASE_TCP_PORT = 15555;
+const int SUBSCRIPTION_TIMEOUT_MS = 5000;
+const std::string BENCH_TOPIC = "BENCH";
+
+/**
+ * @brief Processor producing a payload of fixed size at a fixed rate.
+ * @details Periods of GeneralProcessor are whole milliseconds, so the interval is kept in
+ * nanoseconds here to reach rates above 1000 messages per second.
+ */
+class SyntheticProcessor : public GeneralProcessor {
+public:
+    /**
+     * @brief Constructor for SyntheticProcessor.
+     * @param payloadBytes Size of every output in bytes.
+     * @param intervalNs Time between outputs in nanoseconds, 0 to always be ready.
+     */
+    SyntheticProcessor(size_t payloadBytes, int64_t intervalNs)
+        : payload(payloadBytes, 'x'), interval(intervalNs) {}
+
+    std::vector<std::string> getProcessedOutput() override {
+        return {payload};
+    }
+
+    bool isReadyToProcess() const override {
+        return std::chrono::steady_clock::now() >= getNextProcessTime();
+    }
+
+    std::chrono::steady_clock::time_point getNextProcessTime() const override {
+        return lastProcessTime + interval;
+    }
+
+private:
+    std::string payload;               ///< The output of every processing.
+    std::chrono::nanoseconds interval; ///< Time between outputs.
+};
+
+/**
+ * @brief Counters the subscriber thread collects during the measured time.
+ */
+struct ReceiverResults {
+    std::atomic<bool> measuring{false}; ///< Flag indicating messages are counted.
+    std::atomic<bool> stop{false};      ///< Flag telling the subscriber thread to exit.
+    std::atomic<uint64_t> firstSeen{0}; ///< Messages received before measuring, to detect the subscription.
+    uint64_t messages = 0;              ///< Messages received while measuring.
+    uint64_t bytes = 0;                 ///< Bytes received while measuring, all frames.
+    uint64_t lost = 0;                  ///< Sequence gaps while measuring.
+    std::vector<double> sendLatencies;    ///< Send to receive latencies in microseconds.
+    std::vector<double> processLatencies; ///< Processing to receive latencies in microseconds.
+};
+
+/**
+ * @brief Receives the benchmark channel until told to stop.
+ * @param context The ZeroMQ context, the publisher's for inproc.
+ * @param address The address to connect to.
+ * @param results Receives the counters.
+ */
+void receive(zmq::context_t& context, const std::string& address, ReceiverResults& results) {
+    zmq::socket_t socket(context, ZMQ_SUB);
+    socket.set(zmq::sockopt::subscribe, BENCH_TOPIC);
+    socket.set(zmq::sockopt::rcvtimeo, 100);
+    socket.set(zmq::sockopt::rcvhwm, 0);
+    socket.connect(address);
+
+    std::vector<zmq::message_t> frames(3);
+    uint64_t lastSequence = 0;
+    while (!results.stop) {
+        size_t count = 0;
+        do {
+            frames[count].rebuild();
+            if (!socket.recv(frames[count])) {
+                break;
+            }
+            count++;
+        } while (frames[count - 1].more() && count < frames.size());
+        if (count < 3) {
+            continue;
+        }
+
+        uint64_t nowNs = MessageHeader::MonotonicNowNs();
+        MessageHeader header = MessageHeader::Decode(frames[1].data(), frames[1].size());
+        if (!results.measuring) {
+            results.firstSeen++;
+            lastSequence = header.sequence;
+            continue;
+        }
+        if (header.sequence > lastSequence + 1) {
+            results.lost += header.sequence - lastSequence - 1;
+        }
+        lastSequence = header.sequence;
+        results.messages++;
+        results.bytes += frames[0].size() + frames[1].size() + frames[2].size();
+        results.sendLatencies.push_back((static_cast<double>(nowNs) - header.sentMonotonicNs) / 1000.0);
+        results.processLatencies.push_back((static_cast<double>(nowNs) - header.processedMonotonicNs) / 1000.0);
+    }
+}
+
+/**
+ * @brief Gets the CPU time used so far.
+ * @param who RUSAGE_THREAD for the calling thread, RUSAGE_SELF for the whole process.
+ * @return User and system time in microseconds.
+ */
+double cpuTimeUs(int who) {
+    struct rusage usage;
+    getrusage(who, &usage);
+    return usage.ru_utime.tv_sec * 1e6 + usage.ru_utime.tv_usec + usage.ru_stime.tv_sec * 1e6 + usage.ru_stime.tv_usec;
+}
+
+/**
+ * @brief Splits a comma separated list.
+ * @param list The list.
+ * @return The items.
+ */
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * @brief Builds a unique address for a run.
+ * @param transport One of inproc, ipc or tcp.
+ * @param run Number of the run, keeps the addresses of earlier runs out of the way.
+ * @return The address the channel binds to and the subscriber connects to.
+ * @throws std::runtime_error for unknown transports.
+ */
+std::string makeAddress(const std::string& transport, int run) {
+    if (transport == "inproc") {
+        return "inproc://publisher-bench-" + std::to_string(run);
+    }
+    if (transport == "ipc") {
+        return "ipc:///tmp/publisher-bench-" + std::to_string(getpid()) + "-" + std::to_string(run);
+    }
+    if (transport == "tcp") {
+        return "tcp://127.0.0.1:" + std::to_string(BASE_TCP_PORT + run);
+    }
+    throw std::runtime_error("Unknown transport: " + transport);
+}
+
+/**
+ * @brief Removes the socket file of an ipc address when the run ends, however it ends.
+ */
+struct IpcSocketFile {
+    std::string path; ///< The socket file, empty for other transports.
+
+    /**
+     * @brief Constructor for IpcSocketFile.
+     * @param address The address of the run.
+     */
+    explicit IpcSocketFile(const std::string& address) {
+        const std::string scheme = "ipc://";
+        if (address.compare(0, scheme.size(), scheme) == 0) {
+            path = address.substr(scheme.size());
+        }
+    }
+
+    /**
+     * @brief Destructor for IpcSocketFile. Removes the socket file.
+     */
+    ~IpcSocketFile() {
+        if (!path.empty()) {
+            unlink(path.c_str());
+        }
+    }
+};
+
+/**
+ * @brief Prints the header of the results table.
+ */
+void printResultsHeader() {
+    std::printf("%-24s %10s %10s %8s %10s %10s %10s %10s %10s %10s\n", "run", "msg/s", "MB/s", "lost", "send_p50",
+                "send_p99", "send_max", "proc_p50", "pub_cpu_us", "cpu_us");
+}
+
+/**
+ * @brief Publishes one channel for the duration and prints the results.
+ * @param transport One of inproc, ipc or tcp.
+ * @param payloadBytes Size of every processor output.
+ * @param rate Messages per second, 0 for as fast as possible.
+ * @param durationS Measured time in seconds.
+ * @param run Number of the run.
+ */
+void runBenchmark(const std::string& transport, size_t payloadBytes, int rate, int durationS, int run) {
+    std::string address = makeAddress(transport, run);
+    IpcSocketFile socketFile(address);
+    std::string channelId = "bench-" + std::to_string(run);
+    int64_t intervalNs = rate > 0 ? 1000000000LL / rate : 0;
+
+    GeneralProcessorFactory::Instance().RegisterProcessor("SyntheticProcessor", [payloadBytes, intervalNs]() -> GeneralProcessor* {
+        return new SyntheticProcessor(payloadBytes, intervalNs);
+    });
+    nlohmann::json channelConfig = {
+        {channelId, {
+            {"enabled", true},
+            {"zmq-address", address},
+            {"name", BENCH_TOPIC},
+            {"publishes-per-batch", 1},
+            {"publishes-ignored-after-batch", 0},
+            {"num-events-in-circular-buffer", 1},
+            {"header-frame", true},
+            {"processors", {{{"processor", "SyntheticProcessor"}, {"period-ms", 0}}}}
+        }}
+    };
+    DataChannelManager manager(channelConfig);
+    DataTransmitterManager::Instance().pollSubscriptions(); // Binds before the subscriber connects
+
+    ReceiverResults results;
+    std::thread receiver(receive, std::ref(DataTransmitterManager::Instance().getContext()), address, std::ref(results));
+
+    // Publish until the subscription has arrived and messages flow
+    auto subscribeDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SUBSCRIPTION_TIMEOUT_MS);
+    while (results.firstSeen == 0 && std::chrono::steady_clock::now() < subscribeDeadline) {
+        manager.updateSubscriptions();
+        manager.publishDue();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (results.firstSeen == 0) {
+        results.stop = true;
+        receiver.join();
+        std::printf("%-24s no messages received\n", (transport + " " + std::to_string(payloadBytes) + "B").c_str());
+        return;
+    }
+
+    results.measuring = true;
+    double threadCpuStart = cpuTimeUs(RUSAGE_THREAD);
+    double processCpuStart = cpuTimeUs(RUSAGE_SELF);
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(durationS);
+    while (std::chrono::steady_clock::now() < end) {
+        manager.updateSubscriptions();
+        manager.publishDue();
+        auto nextDeadline = manager.getNextDeadline();
+        if (nextDeadline > std::chrono::steady_clock::now()) {
+            std::this_thread::sleep_until(std::min(nextDeadline, end));
+        }
+    }
+    double threadCpu = cpuTimeUs(RUSAGE_THREAD) - threadCpuStart;
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Let the last messages arrive before stopping the subscriber
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    results.stop = true;
+    receiver.join();
+    double processCpu = cpuTimeUs(RUSAGE_SELF) - processCpuStart;
+
+    LatencySummary send = summarizeLatencies(results.sendLatencies);
+    LatencySummary process = summarizeLatencies(results.processLatencies);
+    double messages = results.messages > 0 ? static_cast<double>(results.messages) : 1.0;
+    std::printf("%-24s %10.0f %10.2f %8llu %10.1f %10.1f %10.1f %10.1f %10.2f %10.2f\n",
+                (transport + " " + std::to_string(payloadBytes) + "B").c_str(), results.messages / elapsed,
+                results.bytes / elapsed / 1e6, static_cast<unsigned long long>(results.lost), send.p50, send.p99,
+                send.max, process.p50, threadCpu / messages, processCpu / messages);
+    std::fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    int durationS = (argc > 1) ? std::stoi(argv[1]) : DEFAULT_DURATION_S;
+    int rate = (argc > 2) ? std::stoi(argv[2]) : DEFAULT_RATE;
+    std::vector<std::string> payloadSizes = splitList((argc > 3) ? argv[3] : DEFAULT_PAYLOAD_SIZES);
+    std::vector<std::string> transports = splitList((argc > 4) ? argv[4] : DEFAULT_TRANSPORTS);
+    bool senderThreads = (argc > 5) && std::stoi(argv[5]) != 0;
+
+    // Must happen before the first transmitter is created, like in the publisher
+    DataTransmitterManager& transmitterManager = DataTransmitterManager::Instance();
+    transmitterManager.setSenderThreads(senderThreads, 1000, DataTransmitter::OverflowPolicy::Block);
+
+    std::printf("duration %d s, rate %s, sender threads %s\n", durationS,
+                rate > 0 ? (std::to_string(rate) + " msg/s").c_str() : "unlimited", senderThreads ? "on" : "off");
+    std::printf("latencies in us, CPU in us per received message (publishing thread / whole process)\n");
+    printResultsHeader();
+
+    int run = 0;
+    for (const std::string& transport : transports) {
+        for (const std::string& size : payloadSizes) {
+            runBenchmark(transport, std::stoul(size), rate, durationS, run++);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file SerializationBenchmark.cpp
+ * @brief Compares publishing cost and payload size of the JSON, MessagePack and CBOR
+ * serialization formats for representative command outputs.
+ *
+ * Every iteration pushes one command output into a full data buffer and serializes the buffer,
+ * which is what a channel in snapshot mode does per publish. Decoding measures what a receiver
+ * pays to turn the payload back into a JSON document.
+ *
+ * Usage: serialization_benchmark [iterations] [buffer-size]
+ */
+
+#include "DataBuffer.h"
+#include "BenchmarkUtils.h"
+#include <string>
+#include <vector>
+
+const int DEFAULT_ITERATIONS = 20000;
+const size_t DEFAULT_BUFFER_SIZE = 10;
+
+/**
+ * @brief A named command output used as buffer entry.
+ */
+struct SampleOutput {
+    std::string name;  ///< Short description of the output.
+    std::string value; ///< The output as a processor produces it.
+};
+
+/**
+ * @brief Builds command outputs typical for the publisher's channels.
+ * @return The sample outputs.
+ */
+std::vector<SampleOutput> makeSampleOutputs() {
+    std::vector<SampleOutput> samples;
+    samples.push_back({"single reading", "23.4719"});
+
+    std::string table;
+    for (int i = 0; i < 16; ++i) {
+        table += "ch" + std::to_string(i) + "\t" + std::to_string(1000 + i * 37) + "\t" + std::to_string(0.125 * i) + "\t" +
+                 std::to_string(-12.5 + i) + "\n";
+    }
+    samples.push_back({"numeric table", table});
+
+    std::string jsonOutput = "{";
+    for (int i = 0; i < 16; ++i) {
+        jsonOutput += (i ? ", " : "") + std::string("\"sensor") + std::to_string(i) + "\": {\"value\": " +
+                      std::to_string(20.0 + i * 0.5) + ", \"unit\": \"C\"}";
+    }
+    jsonOutput += "}";
+    samples.push_back({"json output", jsonOutput});
+
+    std::string log;
+    while (log.size() < 4096) {
+        log += "2024-05-01T12:00:00Z INFO acquisition: read 4096 samples from \"/dev/adc0\" in 1.25 ms\n";
+    }
+    samples.push_back({"4 KiB log", log});
+    return samples;
+}
+
+/**
+ * @brief Decodes a serialized buffer back into a JSON document.
+ * @param payload The serialized buffer.
+ * @param format The format it is serialized in.
+ * @return The decoded document.
+ */
+nlohmann::json decodePayload(const std::string& payload, SerializationFormat format) {
+    switch (format) {
+        case SerializationFormat::MessagePack:
+            return nlohmann::json::from_msgpack(payload);
+        case SerializationFormat::Cbor:
+            return nlohmann::json::from_cbor(payload);
+        default:
+            return nlohmann::json::parse(payload);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = (argc > 1) ? std::stoi(argv[1]) : DEFAULT_ITERATIONS;
+    size_t bufferSize = (argc > 2) ? std::stoul(argv[2]) : DEFAULT_BUFFER_SIZE;
+    const std::vector<SerializationFormat> formats = {SerializationFormat::Json, SerializationFormat::MessagePack,
+                                                      SerializationFormat::Cbor};
+    size_t checksum = 0;
+
+    printLatencyHeader();
+    for (const SampleOutput& sample : makeSampleOutputs()) {
+        for (SerializationFormat format : formats) {
+            std::string label = sample.name + " " + MessageHeader::GetFormatName(format);
+
+            // The buffer holds one more slot than entries, fill it so every publish is full size
+            DataBuffer<std::string> buffer(bufferSize + 1);
+            buffer.SetFormat(format);
+            for (size_t i = 0; i < bufferSize; ++i) {
+                buffer.Push(sample.value);
+            }
+
+            std::vector<double> publishSamples = timeIterations(iterations, [&]() {
+                buffer.Push(sample.value);
+                checksum += buffer.SerializeBufferShared()->size();
+            });
+            std::string payload = buffer.SerializeBuffer();
+            std::vector<double> decodeSamples = timeIterations(iterations / 10 + 1, [&]() {
+                checksum += decodePayload(payload, format).size();
+            });
+
+            LatencySummary publish = summarizeLatencies(publishSamples);
+            printLatencyRow(label + " push+serialize", publish);
+            printLatencyRow(label + " decode", summarizeLatencies(decodeSamples));
+            std::printf("%-40s %10zu bytes %10.1f MB/s\n", (label + " payload").c_str(), payload.size(),
+                        publish.mean > 0 ? payload.size() / publish.mean : 0.0);
+        }
+    }
+    std::printf("checksum %zu\n", checksum);
+
+    return 0;
+}
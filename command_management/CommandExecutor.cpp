@@ -0,0 +1,180 @@
+#include "CommandExecutor.h"
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+const int MAX_EPOLL_EVENTS = 64;
+const size_t OUTPUT_READ_SIZE = 65536;
+
+CommandExecutor::CommandExecutor() : epollFd(epoll_create1(EPOLL_CLOEXEC)) {
+    if (epollFd < 0) {
+        throw std::runtime_error("Failed to create the command executor epoll instance.");
+    }
+}
+
+CommandExecutor::~CommandExecutor() {
+    for (auto& jobPair : runningJobs) {
+        kill(-jobPair.second->pid, SIGKILL);
+        waitpid(jobPair.second->pid, nullptr, 0);
+        close(jobPair.first);
+    }
+    reapChildren();
+    close(epollFd);
+}
+
+CommandExecutor& CommandExecutor::Instance() {
+    static CommandExecutor instance;
+    return instance;
+}
+
+std::shared_ptr<CommandJob> CommandExecutor::watch(pid_t pid, int outputFd, int timeoutMs, std::function<void()> onFinished,
+                                                   std::function<void()> onOutput) {
+    auto job = std::make_shared<CommandJob>();
+    job->pid = pid;
+    job->outputFd = outputFd;
+    job->startTime = std::chrono::steady_clock::now();
+    job->deadline = (timeoutMs > 0) ? job->startTime + std::chrono::milliseconds(timeoutMs)
+                                    : std::chrono::steady_clock::time_point::max();
+    job->onFinished = std::move(onFinished);
+    job->onOutput = std::move(onOutput);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = outputFd;
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, outputFd, &event) < 0) {
+        kill(-pid, SIGKILL);
+        close(outputFd);
+        unreapedPids.push_back(pid);
+        throw std::runtime_error("Failed to watch the command output.");
+    }
+
+    runningJobs[outputFd] = job;
+    return job;
+}
+
+void CommandExecutor::detach(const std::shared_ptr<CommandJob>& job) {
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    job->onFinished = nullptr;
+    job->onOutput = nullptr;
+}
+
+void CommandExecutor::waitForEvents(std::chrono::steady_clock::time_point until) {
+    auto now = std::chrono::steady_clock::now();
+
+    // Wake up in time to kill the first command that runs over its timeout
+    auto wakeTime = until;
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        for (const auto& jobPair : runningJobs) {
+            wakeTime = std::min(wakeTime, jobPair.second->deadline);
+        }
+    }
+
+    int timeoutMs = 0;
+    if (wakeTime > now) {
+        // Round up so we don't wake just before the deadline and spin
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(wakeTime - now + std::chrono::microseconds(999));
+        timeoutMs = static_cast<int>(remaining.count());
+    }
+
+    std::array<epoll_event, MAX_EPOLL_EVENTS> events;
+    int numEvents = epoll_wait(epollFd, events.data(), MAX_EPOLL_EVENTS, timeoutMs);
+
+    // Callbacks run after the lock is released so they may launch new commands
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+
+        // A negative count is EINTR from a signal, the caller checks for that
+        for (int i = 0; i < numEvents; ++i) {
+            auto it = runningJobs.find(events[i].data.fd);
+            if (it == runningJobs.end()) {
+                continue;
+            }
+            std::shared_ptr<CommandJob> job = it->second;
+            if (readOutput(*job)) {
+                finish(job, callbacks);
+            } else if (job->onOutput && !job->output.empty()) {
+                callbacks.push_back(job->onOutput);
+            }
+        }
+
+        killTimedOutJobs(std::chrono::steady_clock::now(), callbacks);
+        reapChildren();
+    }
+
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+size_t CommandExecutor::getRunningCount() const {
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    return runningJobs.size();
+}
+
+bool CommandExecutor::readOutput(CommandJob& job) {
+    std::array<char, OUTPUT_READ_SIZE> buffer;
+
+    while (true) {
+        ssize_t bytesRead = read(job.outputFd, buffer.data(), buffer.size());
+        if (bytesRead > 0) {
+            job.output.append(buffer.data(), static_cast<size_t>(bytesRead));
+        } else if (bytesRead == 0) {
+            return true;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            // EAGAIN means everything available has been read, anything else is treated as closed
+            return errno != EAGAIN && errno != EWOULDBLOCK;
+        }
+    }
+}
+
+void CommandExecutor::finish(std::shared_ptr<CommandJob> job, std::vector<std::function<void()>>& callbacks) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, job->outputFd, nullptr);
+    close(job->outputFd);
+    runningJobs.erase(job->outputFd);
+    job->outputFd = -1;
+    job->finished = true;
+    unreapedPids.push_back(job->pid);
+
+    if (job->onFinished) {
+        callbacks.push_back(job->onFinished);
+    }
+}
+
+void CommandExecutor::killTimedOutJobs(std::chrono::steady_clock::time_point now, std::vector<std::function<void()>>& callbacks) {
+    std::vector<std::shared_ptr<CommandJob>> timedOutJobs;
+    for (const auto& jobPair : runningJobs) {
+        if (jobPair.second->deadline <= now) {
+            timedOutJobs.push_back(jobPair.second);
+        }
+    }
+
+    for (auto& job : timedOutJobs) {
+        // Kill the whole process group so commands started by a shell die too
+        kill(-job->pid, SIGKILL);
+        job->timedOut = true;
+        finish(job, callbacks);
+    }
+}
+
+void CommandExecutor::reapChildren() {
+    auto it = unreapedPids.begin();
+    while (it != unreapedPids.end()) {
+        pid_t result = waitpid(*it, nullptr, WNOHANG);
+        if (result == 0) {
+            ++it;
+        } else {
+            // Either reaped or no longer our child
+            it = unreapedPids.erase(it);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+// CommandExecutor.h
+#ifndef COMMANDEXECUTOR_H
+#define COMMANDEXECUTOR_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <chrono>
+#include <mutex>
+#include <sys/types.h>
+
+/**
+ * @brief State of a command that was launched asynchronously.
+ *
+ * A `CommandJob` is shared between the `CommandRunner` that launched the command and the
+ * `CommandExecutor` that collects its output.
+ */
+struct CommandJob {
+    pid_t pid = -1;                                   ///< Process ID of the child (also its process group).
+    int outputFd = -1;                                ///< Read end of the child's stdout pipe.
+    std::string output;                               ///< Output collected so far.
+    std::chrono::steady_clock::time_point startTime;  ///< Time the command was launched.
+    std::chrono::steady_clock::time_point deadline;   ///< Time after which the command is killed.
+    bool finished = false;                            ///< Flag indicating the child closed its output or was killed.
+    bool timedOut = false;                            ///< Flag indicating the child was killed for running too long.
+    std::function<void()> onFinished;                 ///< Called once when the job finishes.
+    std::function<void()> onOutput;                   ///< Called whenever new output arrives (optional, for streaming jobs).
+};
+
+/**
+ * @brief Multiplexes the output of asynchronously launched commands with epoll.
+ *
+ * The `CommandExecutor` class watches the stdout pipes of running commands, appends their
+ * output as it becomes available, kills commands that exceed their timeout and reaps the
+ * children. It is designed as a singleton and is driven by the main loop, which waits in
+ * \ref waitForEvents instead of sleeping so that finished commands are noticed immediately.
+ * Commands may be launched from worker threads; the job callbacks run on the thread waiting
+ * in \ref waitForEvents, outside of the executor's lock.
+ */
+class CommandExecutor {
+public:
+    /**
+     * @brief Gets the singleton instance of CommandExecutor.
+     * @return Reference to the singleton instance.
+     */
+    static CommandExecutor& Instance();
+
+    /**
+     * @brief Starts watching a child process.
+     * @param pid Process ID of the child. The child must lead its own process group.
+     * @param outputFd Non-blocking read end of the child's stdout pipe. Ownership is taken.
+     * @param timeoutMs Time in milliseconds after which the child is killed (0 for no timeout).
+     * @param onFinished Called once when the job finishes or times out.
+     * @param onOutput Called whenever new output is appended while the job is running (optional).
+     * @return The job that collects the child's output.
+     */
+    std::shared_ptr<CommandJob> watch(pid_t pid, int outputFd, int timeoutMs, std::function<void()> onFinished,
+                                      std::function<void()> onOutput = nullptr);
+
+    /**
+     * @brief Stops calling back the owner of a job, which may be freed before the job finishes.
+     * @param job The job, it is still reaped when the child exits.
+     * @details Must be called from the thread calling \ref waitForEvents.
+     */
+    void detach(const std::shared_ptr<CommandJob>& job);
+
+    /**
+     * @brief Waits for command output until the given time and processes it.
+     * @param until Latest time to return at.
+     * @details Returns early if a watched command finishes, times out, or a signal is received.
+     * With no commands running this is an interruptible sleep.
+     */
+    void waitForEvents(std::chrono::steady_clock::time_point until);
+
+    /**
+     * @brief Gets the number of commands currently being watched.
+     * @return Number of running commands.
+     */
+    size_t getRunningCount() const;
+
+private:
+    /**
+     * @brief Private constructor for CommandExecutor.
+     */
+    CommandExecutor();
+
+    /**
+     * @brief Destructor for CommandExecutor. Kills any commands that are still running.
+     */
+    ~CommandExecutor();
+
+    int epollFd; ///< The epoll instance watching all output pipes.
+    mutable std::mutex jobsMutex; ///< Protects runningJobs and unreapedPids.
+    std::unordered_map<int, std::shared_ptr<CommandJob>> runningJobs; ///< Running jobs by output file descriptor.
+    std::vector<pid_t> unreapedPids; ///< Children that closed their output but have not exited yet.
+
+    /**
+     * @brief Reads everything currently available from a job's output pipe.
+     * @param job The job to read from.
+     * @return True if the pipe reached end of file, false otherwise.
+     */
+    bool readOutput(CommandJob& job);
+
+    /**
+     * @brief Stops watching a job and marks it finished. Must be called with jobsMutex held.
+     * @param job The job to finish.
+     * @param callbacks Receives the job's callback, to be run after the lock is released.
+     */
+    void finish(std::shared_ptr<CommandJob> job, std::vector<std::function<void()>>& callbacks);
+
+    /**
+     * @brief Kills every job whose deadline has passed. Must be called with jobsMutex held.
+     * @param now The current time.
+     * @param callbacks Receives the callbacks of the killed jobs.
+     */
+    void killTimedOutJobs(std::chrono::steady_clock::time_point now, std::vector<std::function<void()>>& callbacks);
+
+    /**
+     * @brief Reaps children that have exited without blocking. Must be called with jobsMutex held.
+     */
+    void reapChildren();
+};
+
+#endif // COMMANDEXECUTOR_H
@@ -4,13 +4,27 @@
 #include <memory>
 #include <cstdio>
 #include <sstream>
+#include <cctype>
 #include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+const size_t OUTPUT_CHUNK_SIZE = 65536;
+const std::string SHELL_PATH = "/bin/sh";
 
 CommandRunner::CommandRunner(const std::string& command)
-    : commandWithArgs_{command}, waitTime_{0} {}
+    : commandWithArgs_{command}, waitTime_{0}, timeout_{0}, useShell_{true}, lastExecutionTimedOut_{false} {}
 
-CommandRunner::CommandRunner(const std::vector<std::string>& commandWithArgs)
-    : commandWithArgs_(commandWithArgs), waitTime_{0} {}
+CommandRunner::CommandRunner(const std::vector<std::string>& commandWithArgs, bool useShell)
+    : commandWithArgs_(commandWithArgs), waitTime_{0}, timeout_{0}, useShell_{useShell}, lastExecutionTimedOut_{false} {}
 
 void CommandRunner::addArgument(const std::string& arg) {
     commandWithArgs_.push_back(arg);
@@ -22,37 +36,62 @@ void CommandRunner::setWaitTime(int milliseconds) {
 
 std::string CommandRunner::execute() {
     std::string output;
-    std::array<char, 128> buffer;
+    std::vector<char> buffer(OUTPUT_CHUNK_SIZE);
 
-    // Build the command string from the vector of strings
-    std::string command;
-    for (const std::string& arg : commandWithArgs_) {
-        command += arg;
-        command += ' ';
-    }
+    int outputFd = -1;
+    pid_t pid = spawnProcess(outputFd);
 
-    // Open a pipe to the command
-    std::shared_ptr<FILE> pipe(popen(command.c_str(), "r"), pclose);
-    if (!pipe) {
-        throw std::runtime_error("Failed to run the command.");
-    }
+    auto startTime = std::chrono::steady_clock::now();
+    lastExecutionTimedOut_ = false;
 
-    // Read the command's output into the string
-    while (!feof(pipe.get())) {
-        if (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-            output += buffer.data();
+    // Read the command's output until it closes stdout or runs over its timeout
+    while (true) {
+        int pollTimeout = -1;
+        if (timeout_ > 0) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+            pollTimeout = std::max(0, timeout_ - static_cast<int>(elapsed.count()));
+        }
+
+        pollfd pollDescriptor{outputFd, POLLIN, 0};
+        int ready = poll(&pollDescriptor, 1, pollTimeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (ready == 0) {
+            // Kill the whole process group so commands started by a shell die too
+            kill(-pid, SIGKILL);
+            lastExecutionTimedOut_ = true;
+            output.clear();
+            break;
+        }
+
+        ssize_t bytesRead = read(outputFd, buffer.data(), buffer.size());
+        if (bytesRead > 0) {
+            output.append(buffer.data(), static_cast<size_t>(bytesRead));
+        } else if (bytesRead == 0 || (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            break;
         }
     }
 
-    lastExecutionTime = std::chrono::high_resolution_clock::now();
+    close(outputFd);
+    waitpid(pid, nullptr, 0);
+
+    lastExecutionTime = std::chrono::steady_clock::now();
     return output;
 }
 
 bool CommandRunner::isReadyForExecution() const {
-    auto currentTime = std::chrono::high_resolution_clock::now();
+    auto currentTime = std::chrono::steady_clock::now();
     return (currentTime - lastExecutionTime) >= std::chrono::milliseconds(waitTime_);
 }
 
+void CommandRunner::skipExecution() {
+    lastExecutionTime = std::chrono::steady_clock::now();
+}
+
 std::string CommandRunner::getCommand() const {
     // Build the command string from the vector of strings
     std::string command;
@@ -66,3 +105,173 @@ std::string CommandRunner::getCommand() const {
 int CommandRunner::getWaitTime() const {
     return waitTime_;
 }
+
+std::chrono::steady_clock::time_point CommandRunner::getNextExecutionTime() const {
+    return lastExecutionTime + std::chrono::milliseconds(waitTime_);
+}
+
+void CommandRunner::setTimeout(int milliseconds) {
+    timeout_ = milliseconds;
+}
+
+int CommandRunner::getTimeout() const {
+    return timeout_;
+}
+
+bool CommandRunner::launch(std::function<void()> onFinished, std::function<void()> onOutput) {
+    if (isRunning()) {
+        return false;
+    }
+
+    int outputFd = -1;
+    pid_t pid = spawnProcess(outputFd);
+    activeJob_ = CommandExecutor::Instance().watch(pid, outputFd, timeout_, std::move(onFinished), std::move(onOutput));
+
+    lastExecutionTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+void CommandRunner::terminate() {
+    if (isRunning()) {
+        // Signal the whole process group so commands started by a shell end too
+        kill(-activeJob_->pid, SIGTERM);
+    }
+}
+
+void CommandRunner::detachCallbacks() {
+    if (isRunning()) {
+        CommandExecutor::Instance().detach(activeJob_);
+    }
+}
+
+bool CommandRunner::isRunning() const {
+    return activeJob_ && !activeJob_->finished;
+}
+
+bool CommandRunner::hasFinishedOutput() const {
+    return activeJob_ && activeJob_->finished;
+}
+
+std::string CommandRunner::takeOutput() {
+    if (!hasFinishedOutput()) {
+        return "";
+    }
+
+    std::shared_ptr<CommandJob> job = std::move(activeJob_);
+    activeJob_.reset();
+    lastExecutionTimedOut_ = job->timedOut;
+    if (job->timedOut) {
+        return "";
+    }
+    return std::move(job->output);
+}
+
+std::string CommandRunner::takeAvailableOutput() {
+    std::string output;
+    if (activeJob_) {
+        output.swap(activeJob_->output);
+    }
+    return output;
+}
+
+bool CommandRunner::lastExecutionTimedOut() const {
+    return lastExecutionTimedOut_;
+}
+
+pid_t CommandRunner::spawnProcess(int& outputFd) const {
+    int pipeFds[2];
+    if (pipe2(pipeFds, O_CLOEXEC) < 0) {
+        throw std::runtime_error("Failed to run the command.");
+    }
+
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_adddup2(&fileActions, pipeFds[1], STDOUT_FILENO);
+
+    // Put the child in its own process group so a timeout can kill everything it started
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attributes, 0);
+
+    // Either hand the joined command line to /bin/sh or exec the argument vector directly
+    std::vector<std::string> arguments;
+    if (useShell_ || commandWithArgs_.empty()) {
+        arguments = {SHELL_PATH, "-c", getCommand()};
+    } else {
+        arguments = commandWithArgs_;
+    }
+    std::vector<char*> argv;
+    argv.reserve(arguments.size() + 1);
+    for (std::string& argument : arguments) {
+        argv.push_back(&argument[0]);
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    int result = posix_spawnp(&pid, argv[0], &fileActions, &attributes, argv.data(), environ);
+
+    posix_spawn_file_actions_destroy(&fileActions);
+    posix_spawnattr_destroy(&attributes);
+    close(pipeFds[1]);
+
+    if (result != 0) {
+        close(pipeFds[0]);
+        throw std::runtime_error("Failed to run the command: " + getCommand());
+    }
+
+    fcntl(pipeFds[0], F_SETFL, fcntl(pipeFds[0], F_GETFL) | O_NONBLOCK);
+    outputFd = pipeFds[0];
+    return pid;
+}
+
+void CommandRunner::setUseShell(bool useShell) {
+    useShell_ = useShell;
+}
+
+bool CommandRunner::getUseShell() const {
+    return useShell_;
+}
+
+std::vector<std::string> CommandRunner::splitCommand(const std::string& command) {
+    std::vector<std::string> arguments;
+    std::string current;
+    bool inArgument = false;
+    char quote = '\0';
+
+    for (size_t i = 0; i < command.size(); ++i) {
+        char c = command[i];
+        if (quote != '\0') {
+            if (c == quote) {
+                quote = '\0';
+            } else if (c == '\\' && quote == '"' && i + 1 < command.size()) {
+                current += command[++i];
+            } else {
+                current += c;
+            }
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+            inArgument = true;
+        } else if (c == '\\' && i + 1 < command.size()) {
+            current += command[++i];
+            inArgument = true;
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            if (inArgument) {
+                arguments.push_back(current);
+                current.clear();
+                inArgument = false;
+            }
+        } else {
+            current += c;
+            inArgument = true;
+        }
+    }
+
+    if (quote != '\0') {
+        throw std::runtime_error("Unterminated quote in command: " + command);
+    }
+    if (inArgument) {
+        arguments.push_back(current);
+    }
+    return arguments;
+}
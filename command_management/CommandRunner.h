@@ -5,6 +5,10 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <memory>
+#include <functional>
+#include <sys/types.h>
+#include "CommandExecutor.h"
 
 /**
  * @brief A utility class for executing commands and managing execution parameters.
@@ -16,15 +20,17 @@ class CommandRunner {
 public:
     /**
      * @brief Constructor for CommandRunner with a single command.
-     * @param command The command to execute.
+     * @param command The command line to execute. It is run through /bin/sh.
      */
     CommandRunner(const std::string& command);
 
     /**
      * @brief Constructor for CommandRunner with a command and arguments.
      * @param commandWithArgs The command and its arguments as a vector of strings.
+     * @param useShell True to join the arguments and run them through /bin/sh, false to
+     * execute the first argument directly with the rest as its arguments (default).
      */
-    CommandRunner(const std::vector<std::string>& commandWithArgs);
+    CommandRunner(const std::vector<std::string>& commandWithArgs, bool useShell = false);
 
     /**
      * @brief Adds an argument to the command.
@@ -40,7 +46,8 @@ public:
 
     /**
      * @brief Executes the command and returns the output.
-     * @return The output of the executed command.
+     * @return The output of the executed command, or an empty string if it timed out.
+     * @details Blocks until the command closes its stdout or runs over the timeout.
      */
     std::string execute();
 
@@ -50,6 +57,12 @@ public:
      */
     bool isReadyForExecution() const;
 
+    /**
+     * @brief Counts the current period as executed without running the command.
+     * @details The next execution is timed from now, as if the command had just run.
+     */
+    void skipExecution();
+
     /**
      * @brief Gets the original command as a string.
      * @return The original command.
@@ -62,10 +75,114 @@ public:
      */
     int getWaitTime() const;
 
+    /**
+     * @brief Gets the time at which the command is next ready for execution.
+     * @return The last execution time plus the wait time.
+     */
+    std::chrono::steady_clock::time_point getNextExecutionTime() const;
+
+    /**
+     * @brief Sets the time after which a running command is killed.
+     * @param milliseconds The timeout in milliseconds (0 for no timeout).
+     */
+    void setTimeout(int milliseconds);
+
+    /**
+     * @brief Gets the time after which a running command is killed.
+     * @return The timeout in milliseconds (0 for no timeout).
+     */
+    int getTimeout() const;
+
+    /**
+     * @brief Launches the command without waiting for it to finish.
+     * @param onFinished Called by the CommandExecutor once the command's output is complete.
+     * @param onOutput Called by the CommandExecutor whenever new output arrives (optional).
+     * @return True if the command was launched, false if a previous launch is still running.
+     * @details The output is collected by the \ref CommandExecutor while the main loop waits.
+     * The next execution is timed from the launch, not from when the command finishes.
+     */
+    bool launch(std::function<void()> onFinished = nullptr, std::function<void()> onOutput = nullptr);
+
+    /**
+     * @brief Terminates an asynchronously launched command that is still running.
+     * @details Its whole process group gets SIGTERM, the \ref CommandExecutor reaps it and
+     * finishes the launch as usual.
+     */
+    void terminate();
+
+    /**
+     * @brief Stops calling back the owner of a running asynchronous launch.
+     * @details Called before the owner is freed, the launch is still reaped when it ends.
+     */
+    void detachCallbacks();
+
+    /**
+     * @brief Checks if an asynchronously launched command is still running.
+     * @return True if running, false otherwise.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Checks if an asynchronously launched command has finished and its output was not taken yet.
+     * @return True if finished output is waiting, false otherwise.
+     */
+    bool hasFinishedOutput() const;
+
+    /**
+     * @brief Takes the output of a finished asynchronous launch.
+     * @return The output of the command, or an empty string if it timed out or nothing has finished.
+     */
+    std::string takeOutput();
+
+    /**
+     * @brief Takes whatever output the current asynchronous launch has produced so far.
+     * @return The output collected since the last call, without waiting for the command to finish.
+     * @details Used to stream the output of long running commands.
+     */
+    std::string takeAvailableOutput();
+
+    /**
+     * @brief Checks if the last execution or taken asynchronous launch was killed for exceeding its timeout.
+     * @return True if it timed out, false otherwise.
+     */
+    bool lastExecutionTimedOut() const;
+
+    /**
+     * @brief Sets whether the command is run through /bin/sh.
+     * @param useShell True to run the joined command line through /bin/sh (needed for pipes,
+     * redirection, variables and globs), false to execute the argument vector directly.
+     */
+    void setUseShell(bool useShell);
+
+    /**
+     * @brief Checks if the command is run through /bin/sh.
+     * @return True if a shell is used, false otherwise.
+     */
+    bool getUseShell() const;
+
+    /**
+     * @brief Splits a command line into arguments the way a shell would for simple commands.
+     * @param command The command line.
+     * @return The arguments, with quotes and backslash escapes removed.
+     * @throws std::runtime_error if a quote is not terminated.
+     */
+    static std::vector<std::string> splitCommand(const std::string& command);
+
 protected:
     std::vector<std::string> commandWithArgs_; ///< The command and its arguments.
     int waitTime_; ///< The wait time between command executions.
-    std::chrono::time_point<std::chrono::high_resolution_clock> lastExecutionTime; ///< Timestamp of the last execution.
+    int timeout_; ///< Time after which the command is killed (0 for no timeout).
+    bool useShell_; ///< Flag indicating the command is run through /bin/sh.
+    std::chrono::time_point<std::chrono::steady_clock> lastExecutionTime; ///< Timestamp of the last execution.
+    std::shared_ptr<CommandJob> activeJob_; ///< The asynchronous launch in progress, if any.
+    bool lastExecutionTimedOut_; ///< Flag indicating the last execution or taken launch timed out.
+
+    /**
+     * @brief Spawns the command with its stdout connected to a non-blocking pipe.
+     * @param outputFd Set to the read end of the pipe.
+     * @return Process ID of the child, which leads its own process group.
+     */
+    pid_t spawnProcess(int& outputFd) const;
 };
 
 #endif // COMMANDRUNNER_H
@@ -0,0 +1,183 @@
+#include "CommandStream.h"
+#include "ProjectPrinter.h"
+#include <stdexcept>
+#include <algorithm>
+
+const size_t LENGTH_PREFIX_SIZE = 4;
+const size_t MAX_PENDING_RECORDS = 10000;
+const size_t MAX_RECORD_SIZE = 64 * 1024 * 1024; ///< Larger records restart the command instead of being buffered.
+
+CommandStream::CommandStream(const CommandRunner& runner, Delimiter delimiter, int restartBackoffMs, int maxRestartBackoffMs)
+    : runner(runner), delimiter(delimiter), restartBackoffMs(restartBackoffMs), maxRestartBackoffMs(maxRestartBackoffMs),
+      currentBackoffMs(restartBackoffMs), restartCount(0), started(false), stopped(false), discardingOutput(false), receivedRecordSinceStart(false) {
+    // Persistent commands are never killed for running too long
+    this->runner.setTimeout(0);
+}
+
+void CommandStream::setReadyCallback(std::function<void()> callback) {
+    readyCallback = std::move(callback);
+}
+
+bool CommandStream::startIfDue() {
+    if (stopped || isRunning() || std::chrono::steady_clock::now() < restartTime) {
+        return false;
+    }
+
+    // Drop the state of the previous run before starting again
+    runner.takeOutput();
+    pendingOutput.clear();
+    discardingOutput = false;
+
+    if (started) {
+        restartCount++;
+        ProjectPrinter printer;
+        printer.PrintWarning("Restarting persistent command (restart " + std::to_string(restartCount) + "): " + runner.getCommand(), __LINE__, __FILE__);
+    }
+
+    started = true;
+    receivedRecordSinceStart = false;
+    runner.launch([this]() { onExit(); }, [this]() { onOutput(); });
+    return true;
+}
+
+std::vector<std::string> CommandStream::takeRecords() {
+    std::vector<std::string> taken;
+    taken.swap(records);
+    return taken;
+}
+
+bool CommandStream::hasRecords() const {
+    return !records.empty();
+}
+
+bool CommandStream::isRunning() const {
+    return runner.isRunning();
+}
+
+std::chrono::steady_clock::time_point CommandStream::getRestartTime() const {
+    return restartTime;
+}
+
+int CommandStream::getRestartCount() const {
+    return restartCount;
+}
+
+void CommandStream::stop() {
+    stopped = true;
+    restartTime = std::chrono::steady_clock::time_point::max();
+    runner.detachCallbacks();
+    runner.terminate();
+}
+
+CommandRunner& CommandStream::getCommandRunner() {
+    return runner;
+}
+
+void CommandStream::setDelimiter(Delimiter newDelimiter) {
+    delimiter = newDelimiter;
+}
+
+void CommandStream::setRestartBackoff(int restartBackoffMs, int maxRestartBackoffMs) {
+    this->restartBackoffMs = restartBackoffMs;
+    this->maxRestartBackoffMs = maxRestartBackoffMs;
+    currentBackoffMs = restartBackoffMs;
+}
+
+CommandStream::Delimiter CommandStream::parseDelimiter(const std::string& name) {
+    if (name == "newline") {
+        return Delimiter::Newline;
+    }
+    if (name == "length") {
+        return Delimiter::LengthPrefixed;
+    }
+    throw std::runtime_error("Unknown record delimiter: " + name);
+}
+
+void CommandStream::collectOutput() {
+    if (discardingOutput) {
+        // The command is being terminated for an oversized record, nothing it writes is used
+        runner.takeAvailableOutput();
+        return;
+    }
+    pendingOutput += runner.takeAvailableOutput();
+    size_t recordsBefore = records.size();
+    size_t position = 0;
+    size_t oversizedRecordLength = 0;
+
+    if (delimiter == Delimiter::Newline) {
+        size_t newline = pendingOutput.find('\n', position);
+        while (newline != std::string::npos) {
+            records.push_back(pendingOutput.substr(position, newline - position));
+            position = newline + 1;
+            newline = pendingOutput.find('\n', position);
+        }
+        if (pendingOutput.size() - position > MAX_RECORD_SIZE) {
+            oversizedRecordLength = pendingOutput.size() - position;
+        }
+    } else {
+        while (pendingOutput.size() - position >= LENGTH_PREFIX_SIZE) {
+            const unsigned char* prefix = reinterpret_cast<const unsigned char*>(pendingOutput.data() + position);
+            size_t recordLength = (static_cast<size_t>(prefix[0]) << 24) | (static_cast<size_t>(prefix[1]) << 16) |
+                                  (static_cast<size_t>(prefix[2]) << 8) | static_cast<size_t>(prefix[3]);
+            if (recordLength > MAX_RECORD_SIZE) {
+                oversizedRecordLength = recordLength;
+                break;
+            }
+            if (pendingOutput.size() - position - LENGTH_PREFIX_SIZE < recordLength) {
+                break;
+            }
+            records.push_back(pendingOutput.substr(position + LENGTH_PREFIX_SIZE, recordLength));
+            position += LENGTH_PREFIX_SIZE + recordLength;
+        }
+    }
+
+    pendingOutput.erase(0, position);
+    if (oversizedRecordLength > 0) {
+        // A runaway or misframed command would otherwise fill the memory, restart it with backoff
+        ProjectPrinter printer;
+        printer.PrintError("Record of " + std::to_string(oversizedRecordLength) + " bytes exceeds the limit of " +
+                           std::to_string(MAX_RECORD_SIZE) + " bytes, terminating persistent command: " + runner.getCommand(), __LINE__, __FILE__);
+        pendingOutput.clear();
+        discardingOutput = true;
+        runner.terminate();
+    }
+    if (records.size() > recordsBefore) {
+        receivedRecordSinceStart = true;
+    }
+
+    // Records are not taken while the channel is suspended, keep only the newest ones
+    if (records.size() > MAX_PENDING_RECORDS) {
+        records.erase(records.begin(), records.begin() + (records.size() - MAX_PENDING_RECORDS));
+    }
+}
+
+void CommandStream::onOutput() {
+    bool hadRecords = hasRecords();
+    collectOutput();
+    if (!hadRecords && hasRecords() && readyCallback) {
+        readyCallback();
+    }
+}
+
+void CommandStream::onExit() {
+    collectOutput();
+
+    // A final line without a trailing newline is still a record
+    if (delimiter == Delimiter::Newline && !pendingOutput.empty()) {
+        records.push_back(pendingOutput);
+        receivedRecordSinceStart = true;
+    }
+    pendingOutput.clear();
+
+    // Back off harder every time the command dies without producing anything
+    if (receivedRecordSinceStart) {
+        currentBackoffMs = restartBackoffMs;
+    }
+    restartTime = stopped ? std::chrono::steady_clock::time_point::max()
+                          : std::chrono::steady_clock::now() + std::chrono::milliseconds(currentBackoffMs);
+    currentBackoffMs = std::min(currentBackoffMs * 2, maxRestartBackoffMs);
+
+    if (readyCallback) {
+        readyCallback();
+    }
+}
@@ -0,0 +1,148 @@
+// CommandStream.h
+#ifndef COMMANDSTREAM_H
+#define COMMANDSTREAM_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include "CommandRunner.h"
+
+/**
+ * @brief Runs a command once and splits its output into records as they arrive.
+ *
+ * The `CommandStream` class keeps a long running co-process alive. The command writes records
+ * to stdout, either one per line or each prefixed with its length, and the stream hands out every
+ * complete record as soon as it has been read. If the command exits it is restarted after a
+ * backoff that doubles with every restart that did not produce a record. Records that are not
+ * taken pile up to a limit, after which the oldest are dropped. A record larger than 64 MiB
+ * is never buffered, the command is terminated and restarted instead.
+ */
+class CommandStream {
+public:
+    /**
+     * @brief How records are separated in the command's output.
+     */
+    enum class Delimiter {
+        Newline,        ///< Every line is a record (the newline is not included).
+        LengthPrefixed  ///< Every record is preceded by its length as a 4 byte big-endian unsigned integer.
+    };
+
+    /**
+     * @brief Constructor for CommandStream.
+     * @param runner The command runner used to start the command.
+     * @param delimiter How records are separated in the output.
+     * @param restartBackoffMs Delay in milliseconds before the first restart.
+     * @param maxRestartBackoffMs Longest delay in milliseconds between restarts.
+     */
+    CommandStream(const CommandRunner& runner = CommandRunner(""), Delimiter delimiter = Delimiter::Newline,
+                  int restartBackoffMs = 1000, int maxRestartBackoffMs = 60000);
+
+    /**
+     * @brief Sets the callback used when records are ready or the command exits.
+     * @param callback Function that reschedules the data channel.
+     */
+    void setReadyCallback(std::function<void()> callback);
+
+    /**
+     * @brief Starts the command if it is not running and its restart time has passed.
+     * @return True if the command was started, false otherwise.
+     */
+    bool startIfDue();
+
+    /**
+     * @brief Terminates the command and stops restarting it.
+     * @details Records already read can still be taken.
+     */
+    void stop();
+
+    /**
+     * @brief Takes every complete record read so far.
+     * @return The complete records in the order they were written.
+     */
+    std::vector<std::string> takeRecords();
+
+    /**
+     * @brief Checks if complete records are waiting to be taken.
+     * @return True if records are waiting, false otherwise.
+     */
+    bool hasRecords() const;
+
+    /**
+     * @brief Checks if the command is running.
+     * @return True if running, false otherwise.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Gets the time at which the command will be (re)started.
+     * @return The restart time, meaningful only while the command is not running.
+     */
+    std::chrono::steady_clock::time_point getRestartTime() const;
+
+    /**
+     * @brief Gets the number of times the command has been restarted after exiting.
+     * @return The number of restarts.
+     */
+    int getRestartCount() const;
+
+    /**
+     * @brief Gets the command runner used to start the command.
+     * @return Reference to the command runner.
+     */
+    CommandRunner& getCommandRunner();
+
+    /**
+     * @brief Sets how records are separated in the output.
+     * @param newDelimiter The record delimiter.
+     */
+    void setDelimiter(Delimiter newDelimiter);
+
+    /**
+     * @brief Sets the restart backoff limits.
+     * @param restartBackoffMs Delay in milliseconds before the first restart.
+     * @param maxRestartBackoffMs Longest delay in milliseconds between restarts.
+     */
+    void setRestartBackoff(int restartBackoffMs, int maxRestartBackoffMs);
+
+    /**
+     * @brief Parses a record delimiter name from the config.
+     * @param name Either "newline" or "length".
+     * @return The matching delimiter.
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static Delimiter parseDelimiter(const std::string& name);
+
+private:
+    CommandRunner runner;  ///< The command runner used to start the command.
+    Delimiter delimiter;   ///< How records are separated in the output.
+    int restartBackoffMs;  ///< Delay before the first restart.
+    int maxRestartBackoffMs; ///< Longest delay between restarts.
+    int currentBackoffMs;  ///< Delay before the next restart.
+    int restartCount;      ///< Number of restarts after the command exited.
+    bool started;          ///< Flag indicating the command has been started at least once.
+    bool stopped;          ///< Flag indicating the stream was stopped and the command is not restarted.
+    bool discardingOutput; ///< Flag indicating the running command is terminated for an oversized record.
+    bool receivedRecordSinceStart; ///< Flag indicating the current run produced a record.
+    std::chrono::steady_clock::time_point restartTime; ///< Time at which the command is (re)started.
+    std::string pendingOutput;        ///< Output that does not form a complete record yet.
+    std::vector<std::string> records; ///< Complete records waiting to be taken.
+    std::function<void()> readyCallback; ///< Reports records or an exited command.
+
+    /**
+     * @brief Moves the command's new output into the pending buffer and extracts complete records.
+     */
+    void collectOutput();
+
+    /**
+     * @brief Called by the CommandExecutor when output arrives.
+     */
+    void onOutput();
+
+    /**
+     * @brief Called by the CommandExecutor when the command exits, schedules the restart.
+     */
+    void onExit();
+};
+
+#endif // COMMANDSTREAM_H
@@ -0,0 +1,56 @@
+#include "ChannelScheduler.h"
+
+ChannelScheduler::ChannelScheduler() : nextGeneration(0) {}
+
+void ChannelScheduler::schedule(const std::string& channelId, Clock::time_point deadline) {
+    uint64_t generation = nextGeneration++;
+    activeGenerations[channelId] = generation;
+    heap.push(Entry{deadline, generation, channelId});
+}
+
+void ChannelScheduler::remove(const std::string& channelId) {
+    // The heap entry is left behind and discarded once it reaches the top
+    activeGenerations.erase(channelId);
+}
+
+std::vector<std::string> ChannelScheduler::popDue(Clock::time_point now) {
+    std::vector<std::string> dueChannels;
+
+    while (!heap.empty() && heap.top().deadline <= now) {
+        Entry entry = heap.top();
+        heap.pop();
+        if (isCurrent(entry)) {
+            activeGenerations.erase(entry.channelId);
+            dueChannels.push_back(entry.channelId);
+        }
+    }
+
+    return dueChannels;
+}
+
+ChannelScheduler::Clock::time_point ChannelScheduler::getNextDeadline() {
+    discardStaleEntries();
+    if (heap.empty()) {
+        return Clock::time_point::max();
+    }
+    return heap.top().deadline;
+}
+
+bool ChannelScheduler::isScheduled(const std::string& channelId) const {
+    return activeGenerations.find(channelId) != activeGenerations.end();
+}
+
+bool ChannelScheduler::empty() const {
+    return activeGenerations.empty();
+}
+
+void ChannelScheduler::discardStaleEntries() {
+    while (!heap.empty() && !isCurrent(heap.top())) {
+        heap.pop();
+    }
+}
+
+bool ChannelScheduler::isCurrent(const Entry& entry) const {
+    auto it = activeGenerations.find(entry.channelId);
+    return it != activeGenerations.end() && it->second == entry.generation;
+}
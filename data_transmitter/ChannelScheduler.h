@@ -0,0 +1,109 @@
+// ChannelScheduler.h
+#ifndef CHANNELSCHEDULER_H
+#define CHANNELSCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief A min-heap of data channel deadlines.
+ *
+ * The `ChannelScheduler` class keeps track of when each data channel is next due to run.
+ * The main loop sleeps until the earliest deadline and then only publishes the channels
+ * whose deadlines have passed, instead of waking up every GCD of all processor periods
+ * and walking every channel.
+ * @details Rescheduling a channel does not search the heap. Instead every channel has a
+ * generation number, and heap entries with an outdated generation are dropped when they
+ * reach the top of the heap.
+ */
+class ChannelScheduler {
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock used for all deadlines.
+
+    /**
+     * @brief Default constructor for ChannelScheduler.
+     */
+    ChannelScheduler();
+
+    /**
+     * @brief Schedules a channel, replacing any deadline it already had.
+     * @param channelId The ID of the data channel.
+     * @param deadline The time at which the channel should next run.
+     */
+    void schedule(const std::string& channelId, Clock::time_point deadline);
+
+    /**
+     * @brief Removes a channel from the scheduler.
+     * @param channelId The ID of the data channel to remove.
+     */
+    void remove(const std::string& channelId);
+
+    /**
+     * @brief Removes and returns every channel whose deadline is at or before the given time.
+     * @param now The current time.
+     * @return IDs of the channels that are due, earliest deadline first.
+     * @details The returned channels are no longer scheduled; the caller is expected to
+     * schedule them again once they have run.
+     */
+    std::vector<std::string> popDue(Clock::time_point now);
+
+    /**
+     * @brief Gets the earliest deadline of all scheduled channels.
+     * @return The earliest deadline, or Clock::time_point::max() if nothing is scheduled.
+     */
+    Clock::time_point getNextDeadline();
+
+    /**
+     * @brief Checks if a channel currently has a deadline.
+     * @param channelId The ID of the data channel.
+     * @return True if the channel is scheduled, false otherwise.
+     */
+    bool isScheduled(const std::string& channelId) const;
+
+    /**
+     * @brief Checks if no channels are scheduled.
+     * @return True if nothing is scheduled, false otherwise.
+     */
+    bool empty() const;
+
+private:
+    /**
+     * @brief A single deadline in the heap.
+     */
+    struct Entry {
+        Clock::time_point deadline; ///< Time at which the channel is due.
+        uint64_t generation;        ///< Generation of the channel when the entry was pushed.
+        std::string channelId;      ///< ID of the data channel.
+    };
+
+    /**
+     * @brief Orders entries so the earliest deadline is at the top of the heap.
+     */
+    struct LaterDeadline {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    std::priority_queue<Entry, std::vector<Entry>, LaterDeadline> heap; ///< Heap of deadlines (may contain stale entries).
+    std::unordered_map<std::string, uint64_t> activeGenerations; ///< Current generation of each scheduled channel.
+    uint64_t nextGeneration; ///< Generation handed out to the next scheduled entry.
+
+    /**
+     * @brief Drops stale entries from the top of the heap.
+     */
+    void discardStaleEntries();
+
+    /**
+     * @brief Checks if a heap entry still represents the channel's current deadline.
+     * @param entry The heap entry to check.
+     * @return True if the entry is current, false if it was superseded or removed.
+     */
+    bool isCurrent(const Entry& entry) const;
+};
+
+#endif // CHANNELSCHEDULER_H
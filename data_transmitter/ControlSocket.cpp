@@ -0,0 +1,59 @@
+#include "ControlSocket.h"
+#include "Logging.h"
+#include <exception>
+
+ControlSocket::ControlSocket(zmq::context_t& context, int verbose)
+    : socket(context, ZMQ_REP), verbose(verbose) {
+    // Do not hold up the exit for a reply nobody reads
+    socket.set(zmq::sockopt::linger, 0);
+}
+
+ControlSocket::~ControlSocket() {
+    socket.close();
+}
+
+bool ControlSocket::bind(const std::string& controlAddress) {
+    try {
+        socket.bind(controlAddress);
+        address = controlAddress;
+        LOG_VERBOSE(verbose, 1, "Listening for control requests on " + address);
+        return true;
+    } catch (const zmq::error_t& e) {
+        LOG_ERROR("Failed to bind control socket to " + controlAddress + ": " + e.what());
+        return false;
+    }
+}
+
+bool ControlSocket::isBound() const {
+    return !address.empty();
+}
+
+size_t ControlSocket::handleRequests(const std::function<nlohmann::json(const nlohmann::json&)>& handler) {
+    if (!isBound()) {
+        return 0;
+    }
+
+    size_t answered = 0;
+    zmq::message_t request;
+    while (socket.recv(request, zmq::recv_flags::dontwait)) {
+        // REP sockets take exactly one reply per request, so every request is answered
+        std::string reply = buildReply(request.to_string(), handler).dump();
+        socket.send(zmq::message_t(reply.data(), reply.size()), zmq::send_flags::none);
+        answered++;
+    }
+    return answered;
+}
+
+nlohmann::json ControlSocket::buildReply(const std::string& request, const std::function<nlohmann::json(const nlohmann::json&)>& handler) const {
+    nlohmann::json parsed = nlohmann::json::parse(request, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object()) {
+        return {{"ok", false}, {"error", "Request is not a JSON object"}};
+    }
+
+    LOG_VERBOSE(verbose, 1, "Control request: " + request);
+    try {
+        return handler(parsed);
+    } catch (const std::exception& e) {
+        return {{"ok", false}, {"error", e.what()}};
+    }
+}
@@ -0,0 +1,75 @@
+// ControlSocket.h
+#ifndef CONTROLSOCKET_H
+#define CONTROLSOCKET_H
+
+#include <string>
+#include <functional>
+#include <zmq.hpp>
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Answers runtime control requests on a ZeroMQ REP socket.
+ *
+ * The `ControlSocket` class lets operators tune a running publisher without restarting it and
+ * dropping every subscriber. Requests and replies are single JSON frames, for example
+ * `{"command": "pause", "channel": "EXAMPLE"}` answered with `{"ok": true}`, or
+ * `{"ok": false, "error": "..."}` if the request could not be applied.
+ * @details The socket is never waited on. The main loop calls \ref handleRequests between
+ * ticks, so every change is applied while no channel is publishing, and a request is answered
+ * within one main loop wakeup.
+ * @see DataChannelManager::handleControlRequest
+ */
+class ControlSocket {
+public:
+    /**
+     * @brief Constructor for ControlSocket.
+     * @param context The ZeroMQ context shared with the transmitters.
+     * @param verbose Verbosity level for logging (default is 0).
+     */
+    ControlSocket(zmq::context_t& context, int verbose = 0);
+
+    /**
+     * @brief Destructor for ControlSocket. Closes the socket.
+     */
+    ~ControlSocket();
+
+    ControlSocket(const ControlSocket&) = delete;
+    ControlSocket& operator=(const ControlSocket&) = delete;
+
+    /**
+     * @brief Binds the socket.
+     * @param address The ZeroMQ address, e.g. ipc:///tmp/publisher-control or tcp://127.0.0.1:5556.
+     * @return True if bound, false otherwise.
+     */
+    bool bind(const std::string& address);
+
+    /**
+     * @brief Checks if the socket is bound.
+     * @return True if bound, false otherwise.
+     */
+    bool isBound() const;
+
+    /**
+     * @brief Answers all requests that arrived since the last call, without waiting.
+     * @param handler Function applying a request and returning the reply.
+     * @return Number of requests answered.
+     * @details Requests that are not valid JSON objects are answered with an error without
+     * calling the handler, exceptions thrown by the handler become error replies.
+     */
+    size_t handleRequests(const std::function<nlohmann::json(const nlohmann::json&)>& handler);
+
+private:
+    zmq::socket_t socket; ///< The REP socket.
+    std::string address; ///< Address the socket is bound to, empty if not bound.
+    int verbose; ///< Verbosity level for logging.
+
+    /**
+     * @brief Builds the reply to a single request.
+     * @param request The request frame.
+     * @param handler Function applying a request and returning the reply.
+     * @return The reply.
+     */
+    nlohmann::json buildReply(const std::string& request, const std::function<nlohmann::json(const nlohmann::json&)>& handler) const;
+};
+
+#endif // CONTROLSOCKET_H
@@ -6,6 +6,10 @@
 #include <string>
 #include <nlohmann/json.hpp>
 #include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include "PayloadEncoder.h"
 
 /**
  * @brief A circular buffer for storing data of a specified type.
@@ -13,6 +17,13 @@
  * The `DataBuffer` class implements a circular buffer to store data of a specified type.
  * It allows pushing new data into the buffer and provides methods to retrieve and serialize
  * the buffered data.
+ * @details Every entry is encoded once when it is pushed, as JSON or in the binary format set
+ * with \ref SetFormat. Serializing the buffer then
+ * only concatenates the cached fragments, and the result is reused until the next push, so
+ * publishing does not rebuild and dump a JSON document of the whole buffer every time. The
+ * result is shared and immutable, so it can be handed to the socket without copying it.
+ * Every entry also gets a sequence number, starting at 1 and increasing by one per push, so
+ * only the entries newer than a given sequence number can be serialized.
  * 
  * @tparam T The type of data to be stored in the buffer.
  */
@@ -23,7 +34,33 @@ public:
      * @brief Constructor for DataBuffer with a specified size.
      * @param size The size of the circular buffer.
      */
-    DataBuffer(size_t size) : bufferSize(size), circularBuffer(size), head(0), tail(0) {}
+    DataBuffer(size_t size)
+        : circularBuffer(size), encodedEntries(size), head(0), tail(0), bufferSize(size),
+          nextSequence(1), format(SerializationFormat::Json) {}
+
+    /**
+     * @brief Sets the format the buffer content is serialized in.
+     * @param newFormat The serialization format.
+     * @details Entries already in the buffer are encoded again in the new format.
+     */
+    void SetFormat(SerializationFormat newFormat) {
+        if (newFormat == format) {
+            return;
+        }
+        format = newFormat;
+        for (size_t i = tail; i != head; i = (i + 1) % bufferSize) {
+            encodedEntries[i] = EncodeEntry(circularBuffer[i]);
+        }
+        serialized.reset();
+    }
+
+    /**
+     * @brief Gets the format the buffer content is serialized in.
+     * @return The serialization format.
+     */
+    SerializationFormat GetFormat() const {
+        return format;
+    }
 
     /**
      * @brief Pushes new data into the circular buffer.
@@ -31,11 +68,14 @@ public:
      */
     void Push(const T& data) {
         circularBuffer[head] = data;
+        encodedEntries[head] = EncodeEntry(data);
         head = (head + 1) % bufferSize;
 
         if (head == tail) {
             tail = (tail + 1) % bufferSize; // Remove the oldest event if the buffer is full
         }
+        nextSequence++;
+        serialized.reset();
     }
 
     /**
@@ -56,20 +96,151 @@ public:
     }
 
     /**
-     * @brief Serializes the buffer content to a JSON string.
-     * @return A JSON string representing the buffered data.
+     * @brief Serializes the buffer content to a string.
+     * @return An array of the buffered data, in the buffer's serialization format.
      */
     std::string SerializeBuffer() const {
-        std::vector<T> buffer = GetBuffer();
-        nlohmann::json jsonBuffer(buffer);
-        return jsonBuffer.dump();
+        return *SerializeBufferShared();
+    }
+
+    /**
+     * @brief Serializes the buffer content to a shared string without copying it.
+     * @return An array of the buffered data, in the buffer's serialization format. It stays
+     * valid after the next push.
+     */
+    std::shared_ptr<const std::string> SerializeBufferShared() const {
+        if (!serialized) {
+            serialized = std::make_shared<const std::string>(JoinEncodedEntries(tail, head));
+        }
+        return serialized;
+    }
+
+    /**
+     * @brief Serializes the entries newer than a sequence number to a string.
+     * @param sequence Sequence number of the last entry that should not be included.
+     * @return An array of the newer entries, oldest first, in the buffer's serialization format.
+     * If entries after the given sequence number were already overwritten, all buffered entries
+     * are included.
+     */
+    std::string SerializeSince(uint64_t sequence) const {
+        uint64_t firstSequence = GetFirstSequence();
+        if (sequence < firstSequence) {
+            return SerializeBuffer();
+        }
+        size_t skipped = static_cast<size_t>(std::min<uint64_t>(sequence - firstSequence + 1, Size()));
+        return JoinEncodedEntries((tail + skipped) % bufferSize, head);
+    }
+
+    /**
+     * @brief Gets the number of entries currently in the buffer.
+     * @return The number of entries.
+     */
+    size_t Size() const {
+        return (head + bufferSize - tail) % bufferSize;
+    }
+
+    /**
+     * @brief Gets the number of entries the buffer holds before overwriting the oldest.
+     * @return The capacity, one less than the size of the circular buffer.
+     */
+    size_t Capacity() const {
+        return bufferSize - 1;
+    }
+
+    /**
+     * @brief Changes the size of the circular buffer, keeping the newest entries.
+     * @param size The new size of the circular buffer, as passed to the constructor (at least 2).
+     * @details Entries keep their cached encodings and sequence numbers, so delta publishes
+     * continue where they left off. Entries that no longer fit are dropped, oldest first.
+     */
+    void Resize(size_t size) {
+        size_t kept = std::min(Size(), size - 1);
+        std::vector<T> resizedBuffer(size);
+        std::vector<std::string> resizedEntries(size);
+        size_t source = (head + bufferSize - kept) % bufferSize;
+        for (size_t i = 0; i < kept; ++i) {
+            resizedBuffer[i] = std::move(circularBuffer[source]);
+            resizedEntries[i] = std::move(encodedEntries[source]);
+            source = (source + 1) % bufferSize;
+        }
+        circularBuffer = std::move(resizedBuffer);
+        encodedEntries = std::move(resizedEntries);
+        bufferSize = size;
+        tail = 0;
+        head = kept;
+        serialized.reset();
+    }
+
+    /**
+     * @brief Gets the sequence number of the oldest entry in the buffer.
+     * @return The oldest sequence number, or the next sequence number if the buffer is empty.
+     */
+    uint64_t GetFirstSequence() const {
+        return nextSequence - Size();
+    }
+
+    /**
+     * @brief Gets the sequence number of the newest entry in the buffer.
+     * @return The newest sequence number, or 0 if nothing was ever pushed.
+     */
+    uint64_t GetLastSequence() const {
+        return nextSequence - 1;
     }
 
 private:
     std::vector<T> circularBuffer; ///< The circular buffer storing the data.
+    std::vector<std::string> encodedEntries; ///< Encoding of every entry, in the same slots as circularBuffer.
     size_t head; ///< The index of the head in the circular buffer.
     size_t tail; ///< The index of the tail in the circular buffer.
     size_t bufferSize; ///< The size of the circular buffer.
+    uint64_t nextSequence; ///< Sequence number given to the next pushed entry.
+    mutable std::shared_ptr<const std::string> serialized; ///< Serialized buffer content, empty until serialized after a push.
+    SerializationFormat format; ///< Format entries are encoded and serialized in.
+
+    /**
+     * @brief Encodes a single entry in the buffer's serialization format.
+     * @param data The entry to encode.
+     * @return The encoding of the entry.
+     */
+    std::string EncodeEntry(const T& data) const {
+        return PayloadEncoder::EncodeValue(nlohmann::json(data), format);
+    }
+
+    /**
+     * @brief Joins the cached encodings of the slots from begin up to end into an array.
+     * @param begin Index of the first slot.
+     * @param end Index one past the last slot (wrapping around the buffer).
+     * @return The array in the buffer's serialization format.
+     */
+    std::string JoinEncodedEntries(size_t begin, size_t end) const {
+        size_t count = 0;
+        size_t totalSize = 9; // Brackets, or the longest binary array header
+        for (size_t i = begin; i != end; i = (i + 1) % bufferSize) {
+            totalSize += encodedEntries[i].size() + 1;
+            count++;
+        }
+
+        std::string joined;
+        joined.reserve(totalSize);
+        if (format != SerializationFormat::Json) {
+            // Binary arrays have their length up front and no separators
+            PayloadEncoder::AppendArrayHeader(joined, count, format);
+            for (size_t i = begin; i != end; i = (i + 1) % bufferSize) {
+                joined += encodedEntries[i];
+            }
+            return joined;
+        }
+
+        joined += '[';
+        for (size_t i = begin; i != end; i = (i + 1) % bufferSize) {
+            if (i != begin) {
+                joined += ',';
+            }
+            joined += encodedEntries[i];
+        }
+        joined += ']';
+        return joined;
+    }
     
     /**
      * @brief Optional method for cleanup logic.
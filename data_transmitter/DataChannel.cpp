@@ -2,49 +2,379 @@
 #include "ProjectPrinter.h"
 #include "DataTransmitterManager.h"
 #include "DataTransmitter.h"
+#include <stdexcept>
+#include <algorithm>
+#include "PayloadEncoder.h"
+#include "PayloadCompressor.h"
+#include "TraceRecorder.h"
 
 const int DEFAULT_CHANNEL_TICK_TIME = 1000;
 
 // Constructors
 DataChannel::DataChannel()
     : name(""), eventsBeforeBreak(1), eventsToIgnoreInBreak(0), address(""),
-      eventsPublished(0), eventsSeen(0), onBreak(false), eventsSeenOnBreak(0) {
+      eventsPublished(0), eventsSeen(0), onBreak(false), eventsSeenOnBreak(0),
+      tickTime(DEFAULT_CHANNEL_TICK_TIME), publishMode(PublishMode::Snapshot), snapshotInterval(0), publishesSinceSnapshot(0),
+      snapshotRequested(false), pendingIsSnapshot(false), lastPublishedSequence(0), pendingSequence(0),
+      sendFailed(std::make_shared<std::atomic<bool>>(false)),
+      suspendWhenUnsubscribed(false), unsubscribedBufferPeriodMs(0), subscribed(false), seenSubscribes(0), bufferDuringBreak(false),
+      serializationFormat(SerializationFormat::Json), compressionCodec(CompressionCodec::None), compressionLevel(0),
+      compressionMinBytes(0), uncompressedBytes(0), compressedBytes(0), headerFrameEnabled(false), messageSequence(0),
+      processedMonotonicNs(0), processedWallNs(0), paused(false) {
 }
 
 DataChannel::DataChannel(const std::string& name, int eventsBeforeBreak, int eventsToIgnoreInBreak)
     : name(name), eventsBeforeBreak(eventsBeforeBreak), eventsToIgnoreInBreak(eventsToIgnoreInBreak), address(""),
-      eventsPublished(0), eventsSeen(0), onBreak(false), eventsSeenOnBreak(0) {
+      eventsPublished(0), eventsSeen(0), onBreak(false), eventsSeenOnBreak(0),
+      tickTime(DEFAULT_CHANNEL_TICK_TIME), publishMode(PublishMode::Snapshot), snapshotInterval(0), publishesSinceSnapshot(0),
+      snapshotRequested(false), pendingIsSnapshot(false), lastPublishedSequence(0), pendingSequence(0),
+      sendFailed(std::make_shared<std::atomic<bool>>(false)),
+      suspendWhenUnsubscribed(false), unsubscribedBufferPeriodMs(0), subscribed(false), seenSubscribes(0), bufferDuringBreak(false),
+      serializationFormat(SerializationFormat::Json), compressionCodec(CompressionCodec::None), compressionLevel(0),
+      compressionMinBytes(0), uncompressedBytes(0), compressedBytes(0), headerFrameEnabled(false), messageSequence(0),
+      processedMonotonicNs(0), processedWallNs(0), paused(false) {
 }
 
 DataChannel::DataChannel(const std::string& name, int eventsBeforeBreak, int eventsToIgnoreInBreak, const std::string& address)
     : name(name), eventsBeforeBreak(eventsBeforeBreak), eventsToIgnoreInBreak(eventsToIgnoreInBreak), address(address),
-      eventsPublished(0), eventsSeen(0), onBreak(false), eventsSeenOnBreak(0) {
+      eventsPublished(0), eventsSeen(0), onBreak(false), eventsSeenOnBreak(0),
+      tickTime(DEFAULT_CHANNEL_TICK_TIME), publishMode(PublishMode::Snapshot), snapshotInterval(0), publishesSinceSnapshot(0),
+      snapshotRequested(false), pendingIsSnapshot(false), lastPublishedSequence(0), pendingSequence(0),
+      sendFailed(std::make_shared<std::atomic<bool>>(false)),
+      suspendWhenUnsubscribed(false), unsubscribedBufferPeriodMs(0), subscribed(false), seenSubscribes(0), bufferDuringBreak(false),
+      serializationFormat(SerializationFormat::Json), compressionCodec(CompressionCodec::None), compressionLevel(0),
+      compressionMinBytes(0), uncompressedBytes(0), compressedBytes(0), headerFrameEnabled(false), messageSequence(0),
+      processedMonotonicNs(0), processedWallNs(0), paused(false) {
     initializeTransmitter();
 }
 
 bool DataChannel::publish() {
-    ProjectPrinter printer;
+    if (paused) {
+        return true;
+    }
     if (!transmitter->isBound()) {
         if (!transmitter->bind()) {
             return false;
         }
     }
+    // Nobody is watching, at most keep the buffer warm at the reduced rate
+    if (isSuspended()) {
+        auto now = std::chrono::steady_clock::now();
+        if (unsubscribedBufferPeriodMs > 0 && now >= lastSuspendedRunTime + std::chrono::milliseconds(unsubscribedBufferPeriodMs)) {
+            processesManager.runProcesses();
+            lastSuspendedRunTime = now;
+        }
+        return true;
+    }
+
+    // Ignored publishes are counted here, before any processing or serialization happens
+    if (isIgnoringPublishes()) {
+        bool countsAsPublish = bufferDuringBreak ? runProcesses() : processesManager.skipProcesses();
+        if (countsAsPublish) {
+            if (metrics) {
+                ChannelMetrics::add(metrics->ignoredPublishes);
+            }
+            seen();
+        }
+        return true;
+    }
+
     // Run the processes and add the output to the data buffer
     // Really ProcessesManager can't have a simple boolean, it needs error codes, but whatever
-    if (processesManager.runProcesses()) { // Will return false if the eventBuffer was not changed
+    uint64_t stageStartNs = metrics ? MessageHeader::MonotonicNowNs() : 0;
+    bool addedNewData = runProcesses(); // Will return false if the eventBuffer was not changed
+    stageStartNs = recordStage(PublishStage::Process, stageStartNs);
+
+    // A delta lost by the sender thread is never sent again, resync the subscribers with a snapshot
+    if (sendFailed->exchange(false) && publishMode == PublishMode::Delta) {
+        requestSnapshot();
+    }
+
+    // A requested snapshot is sent even without new data so new subscribers get the buffer right away
+    if (addedNewData || (snapshotRequested && processesManager.getDataBuffer().Size() > 0)) {
         // Get the serialized data from the data buffer
-        std::string serializedData = processesManager.getDataBuffer().SerializeBuffer();
-        return transmitter->publish(*this, serializedData);
+        std::shared_ptr<const std::string> payload;
+        {
+            TraceScope traceScope("serialize", "channel", metrics ? metrics->channelId : name);
+            payload = serializeForPublish();
+        }
+        stageStartNs = recordStage(PublishStage::Serialize, stageStartNs);
+        {
+            TraceScope traceScope("compress", "channel", metrics ? metrics->channelId : name);
+            payload = compressForPublish(payload);
+        }
+        stageStartNs = recordStage(PublishStage::Compress, stageStartNs);
+        bool success = transmitter->publish(*this, payload);
+        recordStage(PublishStage::Send, stageStartNs);
+        return success;
     }
 
     return true; //Return true if the processes just didn't run for whatever reason, that's not a publishing error
 }
 
+uint64_t DataChannel::recordStage(PublishStage stage, uint64_t startNs) {
+    if (!metrics) {
+        return 0;
+    }
+    uint64_t nowNs = MessageHeader::MonotonicNowNs();
+    metrics->stageLatencies[static_cast<size_t>(stage)].Record(nowNs - startNs);
+    return nowNs;
+}
+
+bool DataChannel::runProcesses() {
+    bool addedNewData = processesManager.runProcesses();
+    if (addedNewData) {
+        processedMonotonicNs = MessageHeader::MonotonicNowNs();
+        processedWallNs = MessageHeader::WallNowNs();
+    }
+    return addedNewData;
+}
+
+std::shared_ptr<const std::string> DataChannel::serializeForPublish() {
+    const DataBuffer<std::string>& dataBuffer = processesManager.getDataBuffer();
+    pendingSequence = dataBuffer.GetLastSequence();
+
+    if (publishMode == PublishMode::Snapshot) {
+        pendingIsSnapshot = true;
+        return dataBuffer.SerializeBufferShared();
+    }
+
+    pendingIsSnapshot = snapshotRequested || (snapshotInterval > 0 && publishesSinceSnapshot >= snapshotInterval);
+    uint64_t firstSequence = pendingIsSnapshot ? dataBuffer.GetFirstSequence()
+                                               : std::max(lastPublishedSequence + 1, dataBuffer.GetFirstSequence());
+    std::string events = pendingIsSnapshot ? dataBuffer.SerializeBuffer() : dataBuffer.SerializeSince(lastPublishedSequence);
+
+    if (serializationFormat != SerializationFormat::Json) {
+        // Same object as in JSON, the events array is already encoded
+        std::string payload;
+        payload.reserve(events.size() + 64);
+        PayloadEncoder::AppendMapHeader(payload, 4, serializationFormat);
+        payload += PayloadEncoder::EncodeValue("first-sequence", serializationFormat);
+        payload += PayloadEncoder::EncodeValue(firstSequence, serializationFormat);
+        payload += PayloadEncoder::EncodeValue("last-sequence", serializationFormat);
+        payload += PayloadEncoder::EncodeValue(pendingSequence, serializationFormat);
+        payload += PayloadEncoder::EncodeValue("snapshot", serializationFormat);
+        payload += PayloadEncoder::EncodeValue(pendingIsSnapshot, serializationFormat);
+        payload += PayloadEncoder::EncodeValue("events", serializationFormat);
+        payload += events;
+        return std::make_shared<const std::string>(std::move(payload));
+    }
+
+    std::string payload;
+    payload.reserve(events.size() + 96);
+    payload += "{\"first-sequence\":" + std::to_string(firstSequence);
+    payload += ",\"last-sequence\":" + std::to_string(pendingSequence);
+    payload += pendingIsSnapshot ? ",\"snapshot\":true" : ",\"snapshot\":false";
+    payload += ",\"events\":";
+    payload += events;
+    payload += '}';
+    return std::make_shared<const std::string>(std::move(payload));
+}
+
+std::shared_ptr<const std::string> DataChannel::compressForPublish(std::shared_ptr<const std::string> payload) {
+    messageSequence++;
+    uncompressedBytes += payload->size();
+    if (metrics) {
+        ChannelMetrics::add(metrics->uncompressedBytes, payload->size());
+    }
+    if (compressionCodec != CompressionCodec::None && payload->size() >= compressionMinBytes &&
+        payload->size() <= UINT32_MAX) {
+        std::string compressed;
+        if (PayloadCompressor::Compress(compressionCodec, compressionLevel, *payload, compressed) &&
+            compressed.size() < payload->size()) {
+            updateHeaderFrame(compressionCodec, static_cast<uint32_t>(payload->size()));
+            compressedBytes += compressed.size();
+            return std::make_shared<const std::string>(std::move(compressed));
+        }
+    }
+
+    updateHeaderFrame(CompressionCodec::None, 0);
+    compressedBytes += payload->size();
+    return payload;
+}
+
+void DataChannel::updateHeaderFrame(CompressionCodec compression, uint32_t uncompressedSize) {
+    // Uncompressed JSON is sent without a header, as it always was, unless asked for
+    if (!headerFrameEnabled && serializationFormat == SerializationFormat::Json && compression == CompressionCodec::None) {
+        headerFrame.clear();
+        return;
+    }
+    MessageHeader header;
+    header.format = serializationFormat;
+    header.compression = compression;
+    header.uncompressedSize = uncompressedSize;
+    header.sequence = messageSequence;
+    header.processedMonotonicNs = processedMonotonicNs;
+    header.processedWallNs = processedWallNs;
+    headerFrame = header.Encode(); // The send time is filled in by the transmitter
+}
+
+void DataChannel::setPublishMode(PublishMode mode) {
+    publishMode = mode;
+}
+
+DataChannel::PublishMode DataChannel::getPublishMode() const {
+    return publishMode;
+}
+
+void DataChannel::setSerializationFormat(SerializationFormat format) {
+    serializationFormat = format;
+    processesManager.setSerializationFormat(format);
+}
+
+SerializationFormat DataChannel::getSerializationFormat() const {
+    return serializationFormat;
+}
+
+const std::string& DataChannel::getHeaderFrame() const {
+    return headerFrame;
+}
+
+std::shared_ptr<std::atomic<bool>> DataChannel::getSendFailedFlag() const {
+    return sendFailed;
+}
+
+void DataChannel::setHeaderFrameEnabled(bool enabled) {
+    headerFrameEnabled = enabled;
+}
+
+uint64_t DataChannel::getMessageSequence() const {
+    return messageSequence;
+}
+
+void DataChannel::setCompression(CompressionCodec codec, int level, size_t minBytes) {
+    compressionCodec = codec;
+    compressionLevel = level;
+    compressionMinBytes = minBytes;
+}
+
+CompressionCodec DataChannel::getCompressionCodec() const {
+    return compressionCodec;
+}
+
+uint64_t DataChannel::getUncompressedBytes() const {
+    return uncompressedBytes;
+}
+
+uint64_t DataChannel::getCompressedBytes() const {
+    return compressedBytes;
+}
+
+void DataChannel::setSnapshotInterval(int publishes) {
+    snapshotInterval = publishes;
+}
+
+void DataChannel::requestSnapshot() {
+    snapshotRequested = true;
+}
+
+void DataChannel::setSuspendWhenUnsubscribed(bool suspend, int bufferPeriodMs) {
+    suspendWhenUnsubscribed = suspend;
+    unsubscribedBufferPeriodMs = bufferPeriodMs;
+}
+
+void DataChannel::setBufferDuringBreak(bool buffer) {
+    bufferDuringBreak = buffer;
+}
+
+void DataChannel::setMetrics(std::shared_ptr<ChannelMetrics> channelMetrics) {
+    metrics = channelMetrics;
+    processesManager.setMetrics(channelMetrics);
+}
+
+ChannelMetrics* DataChannel::getMetrics() const {
+    return metrics.get();
+}
+
+bool DataChannel::isIgnoringPublishes() const {
+    // The publish that ends the break is sent, so it has to be processed normally
+    return onBreak && eventsSeenOnBreak + 1 < eventsToIgnoreInBreak;
+}
+
+bool DataChannel::isSuspended() const {
+    return suspendWhenUnsubscribed && !subscribed;
+}
+
+bool DataChannel::updateSubscriptionState() {
+    subscribed = transmitter && transmitter->hasSubscribers(name);
+
+    // Every subscriber joining late gets the buffer, not only the first one
+    uint64_t subscribes = transmitter ? transmitter->getSubscribeCount(name) : 0;
+    bool gainedSubscriber = subscribes != seenSubscribes;
+    seenSubscribes = subscribes;
+    if (subscribed && gainedSubscriber) {
+        requestSnapshot();
+        return true;
+    }
+    return false;
+}
+
+DataChannel::PublishMode DataChannel::parsePublishMode(const std::string& name) {
+    if (name == "snapshot") {
+        return PublishMode::Snapshot;
+    }
+    if (name == "delta") {
+        return PublishMode::Delta;
+    }
+    throw std::runtime_error("Unknown publish mode: " + name);
+}
+
 void DataChannel::updateTickTime() {
     processesManager.updateProcessorPeriodsGCD();
     tickTime = processesManager.getProcessorPeriodsGCD();
 }
 
+std::chrono::steady_clock::time_point DataChannel::getNextDeadline() const {
+    if (paused) {
+        // Woken up again when resumed
+        return std::chrono::steady_clock::time_point::max();
+    }
+    if (isSuspended()) {
+        if (unsubscribedBufferPeriodMs <= 0) {
+            // Woken up again when a subscriber arrives
+            return std::chrono::steady_clock::time_point::max();
+        }
+        return std::max(processesManager.getNextProcessTime(), lastSuspendedRunTime + std::chrono::milliseconds(unsubscribedBufferPeriodMs));
+    }
+    return processesManager.getNextProcessTime();
+}
+
+void DataChannel::setPaused(bool pause) {
+    paused = pause;
+}
+
+bool DataChannel::isPaused() const {
+    return paused;
+}
+
+bool DataChannel::setProcessorPeriod(size_t index, int periodMs) {
+    if (!processesManager.setProcessorPeriod(index, periodMs)) {
+        return false;
+    }
+    updateTickTime();
+    return true;
+}
+
+std::vector<int> DataChannel::getProcessorPeriods() const {
+    return processesManager.getProcessorPeriods();
+}
+
+void DataChannel::stopProcesses() {
+    processesManager.stopProcessors();
+}
+
+void DataChannel::resizeDataBuffer(size_t numEvents) {
+    processesManager.resizeDataBuffer(numEvents);
+}
+
+const DataBuffer<std::string>& DataChannel::getDataBuffer() const {
+    return processesManager.getDataBuffer();
+}
+
+void DataChannel::setReadyCallback(const std::function<void()>& callback) {
+    processesManager.setReadyCallback(callback);
+}
+
 void DataChannel::setName(const std::string& name) {
     this->name = name;
 }
@@ -64,10 +394,12 @@ void DataChannel::setAddress(const std::string& address) {
 
 void DataChannel::setDataChannelProcessesManager(DataChannelProcessesManager manager) {
     processesManager = manager;
+    processesManager.setSerializationFormat(serializationFormat);
+    processesManager.setMetrics(metrics);
 }
 
-void DataChannel::addProcessToManager(GeneralProcessor* processor) {
-    processesManager.addProcessor(processor);
+void DataChannel::addProcessToManager(std::shared_ptr<GeneralProcessor> processor) {
+    processesManager.addProcessor(std::move(processor));
 }
 
 int DataChannel::getTickTime() const {
@@ -112,9 +444,21 @@ int DataChannel::getEventsSeenOnBreak() const {
 void DataChannel::published() {
     eventsPublished++;
 
+    // Entries count as published once they were sent or queued, a queued delta that fails to send requests a snapshot
+    lastPublishedSequence = pendingSequence;
+    if (pendingIsSnapshot) {
+        snapshotRequested = false;
+        publishesSinceSnapshot = 0;
+    } else {
+        publishesSinceSnapshot++;
+    }
+
     // Check if the data channel should start a break
     if (shouldTakeBreak()) {
         startBreak();
+        if (metrics && eventsToIgnoreInBreak > 0) {
+            ChannelMetrics::add(metrics->breaks);
+        }
     }
 
     if (onBreak) {
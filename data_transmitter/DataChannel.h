@@ -4,7 +4,14 @@
 
 #include <string>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include <vector>
 #include "DataChannelProcessesManager.h"
+#include "MessageHeader.h"
+#include "MetricsRegistry.h"
 
 // Forward declarations to avoid circular imports
 class DataTransmitter;
@@ -19,6 +26,14 @@ class DataTransmitterManager;
  */
 class DataChannel {
 public:
+    /**
+     * @brief What each publish of the data channel contains.
+     */
+    enum class PublishMode {
+        Snapshot, ///< Every publish is a JSON array of the whole circular buffer.
+        Delta     ///< Every publish only contains entries that were not published yet, with their sequence numbers.
+    };
+
     /**
      * @brief Default constructor for DataChannel.
      */
@@ -153,15 +168,220 @@ public:
 
     /**
      * @brief Adds a GeneralProcessor to the DataChannelProcessesManager.
-     * @param processor Pointer to the GeneralProcessor to add.
+     * @param processor The GeneralProcessor to add, shared by copies of the data channel.
      */
-    void addProcessToManager(GeneralProcessor* processor);
+    void addProcessToManager(std::shared_ptr<GeneralProcessor> processor);
 
     /**
      * @brief Updates the tick time for the data channel.
      */
     void updateTickTime();
 
+    /**
+     * @brief Gets the time at which the data channel next needs to publish.
+     * @return The earliest next processing time of the channel's processors.
+     */
+    std::chrono::steady_clock::time_point getNextDeadline() const;
+
+    /**
+     * @brief Sets the callback processors use to report asynchronously ready output.
+     * @param callback Function that reschedules the data channel.
+     */
+    void setReadyCallback(const std::function<void()>& callback);
+
+    /**
+     * @brief Sets what each publish contains.
+     * @param mode The publish mode.
+     * @details In delta mode the payload is a JSON object
+     * `{"first-sequence": a, "last-sequence": b, "snapshot": false, "events": [...]}`
+     * holding only the entries with sequence numbers after the last published one.
+     * Full snapshots use the same object with `"snapshot": true` and every buffered entry.
+     */
+    void setPublishMode(PublishMode mode);
+
+    /**
+     * @brief Gets what each publish contains.
+     * @return The publish mode.
+     */
+    PublishMode getPublishMode() const;
+
+    /**
+     * @brief Sets how often a full snapshot is sent in delta mode.
+     * @param publishes Number of publishes between full snapshots (0 to only send them on request).
+     */
+    void setSnapshotInterval(int publishes);
+
+    /**
+     * @brief Requests that the next publish in delta mode is a full snapshot.
+     */
+    void requestSnapshot();
+
+    /**
+     * @brief Parses a publish mode name from the config.
+     * @param name Either "snapshot" or "delta".
+     * @return The matching publish mode.
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static PublishMode parsePublishMode(const std::string& name);
+
+    /**
+     * @brief Sets the format the payload is serialized in.
+     * @param format The serialization format.
+     * @details Channels that are not serialized as JSON send a \ref MessageHeader frame
+     * before the payload that tells receivers the format.
+     */
+    void setSerializationFormat(SerializationFormat format);
+
+    /**
+     * @brief Gets the format the payload is serialized in.
+     * @return The serialization format.
+     */
+    SerializationFormat getSerializationFormat() const;
+
+    /**
+     * @brief Gets the header frame sent before the payload being published.
+     * @return The encoded \ref MessageHeader, empty if no header frame is sent.
+     */
+    const std::string& getHeaderFrame() const;
+
+    /**
+     * @brief Gets the flag a transmitter's sender thread sets when a message of the channel failed to send.
+     * @return The flag, shared with the messages waiting in send queues.
+     * @details A delta that was queued but never sent would leave subscribers with a gap, so the
+     * next publish of a delta channel with the flag set is a full snapshot.
+     */
+    std::shared_ptr<std::atomic<bool>> getSendFailedFlag() const;
+
+    /**
+     * @brief Sets whether every message carries a header frame.
+     * @param enabled True to send a \ref MessageHeader with the message sequence number and
+     * timestamps before every payload, false to only send it when the format or compression
+     * requires one.
+     */
+    void setHeaderFrameEnabled(bool enabled);
+
+    /**
+     * @brief Gets the sequence number of the last message handed to the transmitter.
+     * @return The message sequence number, 0 if nothing was published yet.
+     */
+    uint64_t getMessageSequence() const;
+
+    /**
+     * @brief Sets how payloads are compressed.
+     * @param codec The compression codec, \ref CompressionCodec::None to not compress.
+     * @param level Compression level, 0 for the codec's default.
+     * @param minBytes Payloads smaller than this are sent uncompressed.
+     * @details Compressed payloads are flagged in the \ref MessageHeader frame. Payloads that
+     * do not get smaller are sent uncompressed.
+     */
+    void setCompression(CompressionCodec codec, int level, size_t minBytes);
+
+    /**
+     * @brief Gets the codec payloads are compressed with.
+     * @return The compression codec.
+     */
+    CompressionCodec getCompressionCodec() const;
+
+    /**
+     * @brief Gets the total size of the published payloads before compression.
+     * @return The number of bytes.
+     */
+    uint64_t getUncompressedBytes() const;
+
+    /**
+     * @brief Gets the total size of the published payloads as sent, after compression.
+     * @return The number of bytes.
+     */
+    uint64_t getCompressedBytes() const;
+
+    /**
+     * @brief Sets whether the data channel stops working while nobody is subscribed to it.
+     * @param suspend True to skip processors, serialization and sending without subscribers.
+     * @param bufferPeriodMs While suspended, run the processors at most once per this many
+     * milliseconds so the buffer stays warm (0 to not run them at all).
+     */
+    void setSuspendWhenUnsubscribed(bool suspend, int bufferPeriodMs = 0);
+
+    /**
+     * @brief Checks if the data channel is currently suspended for lack of subscribers.
+     * @return True if suspended, false otherwise.
+     */
+    bool isSuspended() const;
+
+    /**
+     * @brief Sets whether the processors keep running while the data channel is on a break.
+     * @param buffer True to keep filling the data buffer during breaks, false to skip the
+     * processors as well. Serialization and sending are skipped either way.
+     */
+    void setBufferDuringBreak(bool buffer);
+
+    /**
+     * @brief Pauses or resumes the data channel.
+     * @param pause True to stop running processors and publishing until resumed.
+     * @details Buffered entries and sequence numbers are kept, a resumed channel in delta mode
+     * continues with the entries it did not publish yet.
+     */
+    void setPaused(bool pause);
+
+    /**
+     * @brief Checks if the data channel is paused.
+     * @return True if paused, false otherwise.
+     */
+    bool isPaused() const;
+
+    /**
+     * @brief Changes the period of one of the data channel's processors.
+     * @param index Index of the processor, in the order of the config.
+     * @param periodMs The new period in milliseconds.
+     * @return True if the processor exists, false otherwise.
+     * @details The tick time is updated, the caller reschedules the channel.
+     */
+    bool setProcessorPeriod(size_t index, int periodMs);
+
+    /**
+     * @brief Gets the periods of the data channel's processors.
+     * @return The period of every processor in milliseconds, in the order of the config.
+     */
+    std::vector<int> getProcessorPeriods() const;
+
+    /**
+     * @brief Stops the background work of the processors before the data channel is removed.
+     */
+    void stopProcesses();
+
+    /**
+     * @brief Changes how many entries the data buffer holds, keeping the newest.
+     * @param numEvents Number of entries, at least 1.
+     */
+    void resizeDataBuffer(size_t numEvents);
+
+    /**
+     * @brief Gets the data buffer of the data channel.
+     * @return Reference to the data buffer.
+     */
+    const DataBuffer<std::string>& getDataBuffer() const;
+
+    /**
+     * @brief Sets the counters the data channel reports to the metrics endpoint.
+     * @param channelMetrics The counters, shared with the processes manager and the registry.
+     * @see MetricsRegistry
+     */
+    void setMetrics(std::shared_ptr<ChannelMetrics> channelMetrics);
+
+    /**
+     * @brief Gets the counters of the data channel.
+     * @return The counters, or nullptr if the channel does not report metrics.
+     */
+    ChannelMetrics* getMetrics() const;
+
+    /**
+     * @brief Re-evaluates whether anybody subscribes to the data channel.
+     * @return True if somebody subscribed to the channel since the last update, false otherwise.
+     * @details A channel that gains a subscriber requests a snapshot so the new subscriber
+     * immediately receives the buffered data.
+     */
+    bool updateSubscriptionState();
+
 private:
     std::string name; ///< Name of the data channel.
     int eventsBeforeBreak; ///< Number of events before taking a break.
@@ -174,6 +394,33 @@ private:
     std::shared_ptr<DataTransmitter> transmitter; ///< DataTransmitter for publishing events.
     DataChannelProcessesManager processesManager; ///< Manager for data channel processes.
     int tickTime; ///< Tick time for the data channel.
+    PublishMode publishMode; ///< What each publish contains.
+    int snapshotInterval; ///< Publishes between full snapshots in delta mode (0 for on request only).
+    int publishesSinceSnapshot; ///< Publishes since the last full snapshot.
+    bool snapshotRequested; ///< Flag indicating the next delta publish should be a full snapshot.
+    bool pendingIsSnapshot; ///< Flag indicating the payload being published is a full snapshot.
+    uint64_t lastPublishedSequence; ///< Sequence number of the newest entry that was published.
+    uint64_t pendingSequence; ///< Sequence number of the newest entry in the payload being published.
+    std::shared_ptr<std::atomic<bool>> sendFailed; ///< Set by a sender thread when a queued message of the channel was not sent.
+    bool suspendWhenUnsubscribed; ///< Flag indicating the channel stops working without subscribers.
+    int unsubscribedBufferPeriodMs; ///< Processor period while suspended (0 for not running them).
+    bool subscribed; ///< Flag indicating somebody subscribed to the channel at the last update.
+    uint64_t seenSubscribes; ///< Subscribe count of the transmitter for the channel at the last update.
+    std::chrono::steady_clock::time_point lastSuspendedRunTime; ///< Time the processors last ran while suspended.
+    bool bufferDuringBreak; ///< Flag indicating the processors keep running while on a break.
+    SerializationFormat serializationFormat; ///< Format the payload is serialized in.
+    std::string headerFrame; ///< Encoded header frame sent before the payload being published, empty for none.
+    CompressionCodec compressionCodec; ///< Codec payloads are compressed with.
+    int compressionLevel; ///< Compression level, 0 for the codec's default.
+    size_t compressionMinBytes; ///< Smallest payload that is compressed.
+    uint64_t uncompressedBytes; ///< Total size of the published payloads before compression.
+    uint64_t compressedBytes; ///< Total size of the published payloads as sent.
+    bool headerFrameEnabled; ///< Flag indicating every message carries a header frame.
+    uint64_t messageSequence; ///< Sequence number of the last message handed to the transmitter.
+    uint64_t processedMonotonicNs; ///< Monotonic time the processors last added data, in ns.
+    uint64_t processedWallNs; ///< Wall clock time the processors last added data, in ns since the Unix epoch.
+    std::shared_ptr<ChannelMetrics> metrics; ///< Counters for the metrics endpoint, null if not reported.
+    bool paused; ///< Flag indicating the channel was paused at runtime.
 
     /**
      * @brief Checks if a break should be taken based on the configured criteria in \ref config.json.
@@ -186,10 +433,50 @@ private:
      */
     void startBreak();
 
+    /**
+     * @brief Checks if the next publish is ignored because of the break.
+     * @return True if on a break that does not end with the next publish, false otherwise.
+     */
+    bool isIgnoringPublishes() const;
+
     /**
      * @brief Initializes the DataTransmitter for the data channel.
      */
     void initializeTransmitter();
+
+    /**
+     * @brief Serializes the data buffer according to the publish mode.
+     * @return The payload to publish, shared with the data buffer's cache in snapshot mode.
+     */
+    std::shared_ptr<const std::string> serializeForPublish();
+
+    /**
+     * @brief Compresses a serialized payload if configured and builds its header frame.
+     * @param payload The serialized payload.
+     * @return The payload to send, compressed or the given one.
+     */
+    std::shared_ptr<const std::string> compressForPublish(std::shared_ptr<const std::string> payload);
+
+    /**
+     * @brief Updates the header frame for the payload being published.
+     * @param compression Codec the payload is compressed with.
+     * @param uncompressedSize Size of the payload before compression, 0 if not compressed.
+     */
+    void updateHeaderFrame(CompressionCodec compression, uint32_t uncompressedSize);
+
+    /**
+     * @brief Runs the processes and remembers when they added data.
+     * @return True if new data was added to the data buffer, false otherwise.
+     */
+    bool runProcesses();
+
+    /**
+     * @brief Records how long a stage of a publish took.
+     * @param stage The stage that just ended.
+     * @param startNs Monotonic time the stage started, in ns.
+     * @return Monotonic time now, the start of the next stage, or 0 without metrics.
+     */
+    uint64_t recordStage(PublishStage stage, uint64_t startNs);
 };
 
 #endif // DATA_CHANNEL_H
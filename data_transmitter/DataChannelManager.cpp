@@ -4,10 +4,18 @@
 #include "GeneralProcessor.h"
 #include "CommandProcessor.h"
 #include "CommandRunner.h"
-#include "ProjectPrinter.h"
+#include "Logging.h"
+#include "PayloadCompressor.h"
 #include "TypeChecker.h"
+#include "DataTransmitterManager.h"
+#include "MetricsRegistry.h"
+#include "TraceRecorder.h"
 #include <algorithm> // Include for std::gcd
 #include <iostream>
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <optional>
 
 //Default config
 const std::string DEFAULT_NAME                   = "";
@@ -18,6 +26,29 @@ const std::string DEFAULT_ZMQ_ADDRESS            = "tcp://127.0.0.1:5555";
 const int DEFAULT_PERIOD_MS                      = 1000;
 const std::string DEFAULT_COMMAND_STRING         = "";
 const bool DEFAULT_ENABLED_VALUE                 = true;
+const bool DEFAULT_ASYNC_VALUE                   = false;
+const int DEFAULT_TIMEOUT_MS                     = 0;
+const bool DEFAULT_PERSISTENT_VALUE              = false;
+const std::string DEFAULT_RECORD_DELIMITER       = "newline";
+const int DEFAULT_RESTART_BACKOFF_MS             = 1000;
+const int DEFAULT_MAX_RESTART_BACKOFF_MS         = 60000;
+const std::string DEFAULT_PUBLISH_MODE           = "snapshot";
+const int DEFAULT_SNAPSHOT_INTERVAL              = 0;
+const bool DEFAULT_SUSPEND_WHEN_UNSUBSCRIBED     = false;
+const int DEFAULT_UNSUBSCRIBED_BUFFER_PERIOD_MS  = 0;
+const bool DEFAULT_BUFFER_DURING_BREAK           = false;
+const std::string DEFAULT_SERIALIZATION          = "json";
+const std::string DEFAULT_COMPRESSION            = "none";
+const int DEFAULT_COMPRESSION_LEVEL              = 0;
+const size_t DEFAULT_COMPRESSION_MIN_BYTES       = 1024;
+const bool DEFAULT_HEADER_FRAME                  = false;
+
+// Channel settings a reload applies to the running channel, other changes rebuild it
+const std::vector<std::string> UPDATABLE_CHANNEL_SETTINGS = {
+    "publishes-per-batch", "publishes-ignored-after-batch", "num-events-in-circular-buffer", "socket-options",
+    "publish-mode", "snapshot-every-n-publishes", "suspend-when-unsubscribed", "unsubscribed-buffer-period-ms",
+    "buffer-during-break", "serialization", "header-frame", "compression", "compression-level", "compression-min-bytes"
+};
 
 DataChannelManager::DataChannelManager(const nlohmann::json& channelConfig, int verbose) 
     : verbose(verbose) {
@@ -32,20 +63,118 @@ DataChannelManager::DataChannelManager(const nlohmann::json& channelConfig, int
 }
 
 bool DataChannelManager::publish() {
-    bool success = true;
+    std::vector<std::string> channelIds;
+    for (const auto& channelPair : channels) {
+        channelIds.push_back(channelPair.first);
+    }
+    return publishChannels(channelIds);
+}
 
-    for (auto& channelPair : channels) {
-        if (!channelPair.second.publish()) {
-            success = false;
-            ProjectPrinter printer;
-            printer.PrintWarning("Channel " + channelPair.first + " has failed to publish.", __LINE__, __FILE__);
-            channelPair.second.printAttributes();
+bool DataChannelManager::publishDue() {
+    std::vector<std::string> dueChannels = scheduler.popDue(std::chrono::steady_clock::now());
+    bool success = publishChannels(dueChannels);
+
+    // Reschedule once every channel is done, the scheduler is only used by this thread
+    for (const auto& channelId : dueChannels) {
+        auto it = channels.find(channelId);
+        if (it != channels.end()) {
+            scheduler.schedule(channelId, it->second.getNextDeadline());
         }
     }
 
     return success;
 }
 
+void DataChannelManager::setWorkerThreads(size_t numThreads) {
+    if (numThreads <= 1) {
+        workerPool.reset();
+        return;
+    }
+    workerPool = std::make_unique<ThreadPool>(numThreads);
+    LOG_VERBOSE(verbose, 1, "Publishing channels on " + std::to_string(numThreads) + " worker threads");
+}
+
+bool DataChannelManager::publishChannels(const std::vector<std::string>& channelIds) {
+    // A single channel gains nothing from a thread hop
+    if (!workerPool || channelIds.size() < 2) {
+        bool success = true;
+        for (const auto& channelId : channelIds) {
+            auto it = channels.find(channelId);
+            if (it != channels.end() && !publishChannel(it->first, it->second)) {
+                success = false;
+            }
+        }
+        return success;
+    }
+
+    // Channels are independent, channels sharing a transmitter are serialized on its socket
+    std::atomic<bool> success(true);
+    for (const auto& channelId : channelIds) {
+        auto it = channels.find(channelId);
+        if (it == channels.end()) {
+            continue;
+        }
+        DataChannel* channel = &it->second;
+        const std::string* id = &it->first;
+        workerPool->submit([this, channel, id, &success]() {
+            if (!publishChannel(*id, *channel)) {
+                success = false;
+            }
+        });
+    }
+    workerPool->waitIdle();
+    return success;
+}
+
+std::chrono::steady_clock::time_point DataChannelManager::getNextDeadline() {
+    return scheduler.getNextDeadline();
+}
+
+void DataChannelManager::updateSubscriptions() {
+    if (!DataTransmitterManager::Instance().pollSubscriptions()) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    for (auto& channelPair : channels) {
+        if (channelPair.second.updateSubscriptionState()) {
+            LOG_VERBOSE(verbose, 1, "Channel " + channelPair.first + " has a new subscriber, sending a snapshot.");
+            scheduler.schedule(channelPair.first, now);
+        }
+    }
+}
+
+bool DataChannelManager::publishChannel(const std::string& channelId, DataChannel& channel) {
+    TraceScope traceScope("publish", "channel", channelId);
+    if (!channel.publish()) {
+        if (ChannelMetrics* metrics = channel.getMetrics()) {
+            ChannelMetrics::add(metrics->failures);
+        }
+        ProjectPrinter printer;
+        printer.PrintWarning("Channel " + channelId + " has failed to publish.", __LINE__, __FILE__);
+        channel.printAttributes();
+        return false;
+    }
+    return true;
+}
+
+SocketOptions DataChannelManager::parseSocketOptions(const nlohmann::json& optionsConfig) const {
+    SocketOptions options;
+    if (optionsConfig.contains("sndhwm")) {
+        options.sendHighWaterMark = optionsConfig["sndhwm"].get<int>();
+    }
+    if (optionsConfig.contains("sndbuf")) {
+        options.sendBuffer = optionsConfig["sndbuf"].get<int>();
+    }
+    if (optionsConfig.contains("immediate")) {
+        options.immediate = optionsConfig["immediate"].get<bool>();
+    }
+    if (optionsConfig.contains("linger-ms")) {
+        options.lingerMs = optionsConfig["linger-ms"].get<int>();
+    }
+    return options;
+}
+
 DataChannel* DataChannelManager::getChannel(const std::string& channelId) {
     auto it = channels.find(channelId);
     if (it != channels.end()) {
@@ -67,7 +196,12 @@ std::vector<DataChannel> DataChannelManager::getAllChannels() const {
 }
 
 void DataChannelManager::addChannel(const std::string& channelId, DataChannel dataChannel) {
+    if (!dataChannel.getMetrics()) {
+        dataChannel.setMetrics(MetricsRegistry::Instance().getChannelMetrics(channelId, dataChannel.getName(), dataChannel.getAddress()));
+    }
     channels[channelId] = dataChannel;
+    channelConfigs.erase(channelId);
+    scheduler.schedule(channelId, std::chrono::steady_clock::now());
 }
 
 void DataChannelManager::addChannel(const std::string& channelId, const nlohmann::json& channelConfig) {
@@ -123,6 +257,8 @@ void DataChannelManager::addChannel(const std::string& channelId, const nlohmann
     //Initialize DataChannel (will also link to a DataTransmitter class)
     DataChannel dataChannel(name, publishesPerBatch, publishesIgnoredAfterBatch, zmq_address);
 
+    applyChannelSettings(channelId, dataChannel, channelConfig);
+
     DataChannelProcessesManager processesManager(channelConfig["num-events-in-circular-buffer"].get<size_t>() + 1, verbose);
     dataChannel.setDataChannelProcessesManager(processesManager);
 
@@ -132,29 +268,50 @@ void DataChannelManager::addChannel(const std::string& channelId, const nlohmann
 
         // Iterate through processors
         for (const auto& processorConfig : processorsConfig) {
-            GeneralProcessor* processor;
+            // Owned by the data channel from here on, also if configuring it fails
+            std::shared_ptr<GeneralProcessor> processor;
             if (processorConfig.contains("processor")) {
                 std::string processorType = processorConfig["processor"].get<std::string>();
-                processor = factory.CreateProcessor(processorType);
+                processor.reset(factory.CreateProcessor(processorType));
             } else {
                 printer.PrintWarning("Processor type not found in channel " + channelId + " configuration, using default processor: GeneralProcessor", __LINE__, __FILE__);
-                processor = factory.CreateProcessor("GeneralProcessor");
+                processor.reset(factory.CreateProcessor("GeneralProcessor"));
             }
             if (TypeChecker::IsInstanceOf<CommandProcessor>(processor)) {
                 // Cast to CommandProcessor
-                auto commandProcessor = dynamic_cast<CommandProcessor*>(processor);
-                std::string commandString = DEFAULT_COMMAND_STRING;
-                if (processorConfig.contains("command")) {
-                    commandString = processorConfig["command"].get<std::string>();
+                auto commandProcessor = std::dynamic_pointer_cast<CommandProcessor>(processor);
+                std::vector<std::string> commandWithArgs = {DEFAULT_COMMAND_STRING};
+                bool useShell = true;
+                if (processorConfig.contains("command") && processorConfig["command"].is_array()) {
+                    // An argument vector is executed directly unless a shell is requested
+                    commandWithArgs = processorConfig["command"].get<std::vector<std::string>>();
+                    useShell = processorConfig.value("shell", false);
+                } else if (processorConfig.contains("command")) {
+                    // A command line goes through /bin/sh like before, unless the shell is turned off explicitly
+                    std::string commandString = processorConfig["command"].get<std::string>();
+                    useShell = processorConfig.value("shell", true);
+                    commandWithArgs = useShell ? std::vector<std::string>{commandString} : CommandRunner::splitCommand(commandString);
                 } else {
                     printer.PrintWarning("Command not found in channel " + channelId + " configuration, using default command: None", __LINE__, __FILE__);
                 }
                 // Create a CommandRunner and set the command
-                CommandRunner commandRunner(commandString);
+                CommandRunner commandRunner(commandWithArgs, useShell);
+                commandRunner.setTimeout(processorConfig.value("timeout-ms", DEFAULT_TIMEOUT_MS));
 
                 // Create a CommandProcessor with the CommandRunner
                 commandProcessor->setCommandRunner(commandRunner);
 
+                // Optional execution mode settings, silently defaulted
+                commandProcessor->setAsync(processorConfig.value("async", DEFAULT_ASYNC_VALUE));
+
+                bool persistent = processorConfig.value("persistent", DEFAULT_PERSISTENT_VALUE);
+                if (persistent) {
+                    std::string delimiterName = processorConfig.value("record-delimiter", DEFAULT_RECORD_DELIMITER);
+                    int restartBackoff = processorConfig.value("restart-backoff-ms", DEFAULT_RESTART_BACKOFF_MS);
+                    int maxRestartBackoff = processorConfig.value("max-restart-backoff-ms", DEFAULT_MAX_RESTART_BACKOFF_MS);
+                    commandProcessor->setPersistent(true, CommandStream::parseDelimiter(delimiterName), restartBackoff, maxRestartBackoff);
+                }
+
                 if (processorConfig.contains("period-ms")) {
                     commandProcessor->setPeriod(processorConfig["period-ms"].get<int>());
                 } else {
@@ -175,13 +332,195 @@ void DataChannelManager::addChannel(const std::string& channelId, const nlohmann
         }
     }
     dataChannel.updateTickTime();
+
+    // Asynchronous processors wake the channel as soon as their output is ready
+    dataChannel.setReadyCallback([this, channelId]() {
+        scheduler.schedule(channelId, std::chrono::steady_clock::now());
+    });
+
+    dataChannel.setMetrics(MetricsRegistry::Instance().getChannelMetrics(channelId, name, zmq_address));
+
     channels[channelId] = dataChannel;
+    channelConfigs[channelId] = channelConfig;
+    scheduler.schedule(channelId, std::chrono::steady_clock::now());
+}
+
+void DataChannelManager::applyChannelSettings(const std::string& channelId, DataChannel& dataChannel, const nlohmann::json& channelConfig) {
+    ProjectPrinter printer;
+
+    // Socket options are per address, channels sharing an address share the socket
+    if (channelConfig.contains("socket-options")) {
+        DataTransmitterManager::Instance().setSocketOptions(dataChannel.getAddress(), parseSocketOptions(channelConfig["socket-options"]));
+    }
+
+    // Optional publish mode settings, silently defaulted
+    dataChannel.setPublishMode(DataChannel::parsePublishMode(channelConfig.value("publish-mode", DEFAULT_PUBLISH_MODE)));
+    dataChannel.setSnapshotInterval(channelConfig.value("snapshot-every-n-publishes", DEFAULT_SNAPSHOT_INTERVAL));
+    dataChannel.setSuspendWhenUnsubscribed(channelConfig.value("suspend-when-unsubscribed", DEFAULT_SUSPEND_WHEN_UNSUBSCRIBED),
+                                           channelConfig.value("unsubscribed-buffer-period-ms", DEFAULT_UNSUBSCRIBED_BUFFER_PERIOD_MS));
+    dataChannel.setBufferDuringBreak(channelConfig.value("buffer-during-break", DEFAULT_BUFFER_DURING_BREAK));
+    dataChannel.setSerializationFormat(MessageHeader::ParseFormat(channelConfig.value("serialization", DEFAULT_SERIALIZATION)));
+    dataChannel.setHeaderFrameEnabled(channelConfig.value("header-frame", DEFAULT_HEADER_FRAME));
+
+    CompressionCodec compression = PayloadCompressor::ParseCodec(channelConfig.value("compression", DEFAULT_COMPRESSION));
+    if (!PayloadCompressor::IsAvailable(compression)) {
+        printer.PrintWarning("Compression " + PayloadCompressor::GetCodecName(compression) + " of channel " + channelId +
+                             " is not available in this build, publishing uncompressed", __LINE__, __FILE__);
+        compression = CompressionCodec::None;
+    }
+    dataChannel.setCompression(compression, channelConfig.value("compression-level", DEFAULT_COMPRESSION_LEVEL),
+                               channelConfig.value("compression-min-bytes", DEFAULT_COMPRESSION_MIN_BYTES));
+}
+
+/**
+ * @brief Checks if a channel configuration is enabled, the same way as \ref DataChannelManager::addChannel.
+ * @param channelConfig JSON configuration of the channel.
+ * @return True if enabled, false otherwise.
+ */
+static bool isChannelEnabled(const nlohmann::json& channelConfig) {
+    return channelConfig.is_object() && channelConfig.value("enabled", DEFAULT_ENABLED_VALUE);
+}
+
+/**
+ * @brief Removes the settings a running channel can take over from its configuration.
+ * @param channelConfig JSON configuration of the channel.
+ * @return The configuration without \ref UPDATABLE_CHANNEL_SETTINGS and processor periods.
+ */
+static nlohmann::json withoutUpdatableSettings(const nlohmann::json& channelConfig) {
+    nlohmann::json structure = channelConfig;
+    for (const auto& key : UPDATABLE_CHANNEL_SETTINGS) {
+        structure.erase(key);
+    }
+    if (structure.contains("processors") && structure["processors"].is_array()) {
+        for (auto& processorConfig : structure["processors"]) {
+            if (processorConfig.is_object()) {
+                processorConfig.erase("period-ms");
+            }
+        }
+    }
+    return structure;
+}
+
+void DataChannelManager::reloadChannels(const nlohmann::json& channelConfig) {
+    auto startTime = std::chrono::steady_clock::now();
+    size_t added = 0, removed = 0, rebuilt = 0, updated = 0, unchanged = 0;
+
+    // Channels that left the config or were disabled
+    std::vector<std::string> removedChannels;
+    for (const auto& configPair : channelConfigs) {
+        if (!channelConfig.contains(configPair.first) || !isChannelEnabled(channelConfig[configPair.first])) {
+            removedChannels.push_back(configPair.first);
+        }
+    }
+    for (const auto& channelId : removedChannels) {
+        LOG_VERBOSE(verbose, 1, "Reload removes channel " + channelId);
+        removeChannel(channelId);
+        removed++;
+    }
+
+    // A channel that fails to reload keeps running as it was
+    for (auto it = channelConfig.begin(); it != channelConfig.end(); ++it) {
+        const std::string& channelId = it.key();
+        if (!isChannelEnabled(it.value())) {
+            continue;
+        }
+        auto previous = channelConfigs.find(channelId);
+        try {
+            if (previous != channelConfigs.end() && previous->second == it.value()) {
+                unchanged++;
+            } else if (previous != channelConfigs.end() && withoutUpdatableSettings(previous->second) == withoutUpdatableSettings(it.value())) {
+                LOG_VERBOSE(verbose, 1, "Reload updates channel " + channelId);
+                updateChannel(channelId, it.value());
+                updated++;
+            } else if (channels.count(channelId) > 0) {
+                LOG_VERBOSE(verbose, 1, "Reload rebuilds channel " + channelId);
+                rebuildChannel(channelId, it.value());
+                rebuilt++;
+            } else {
+                LOG_VERBOSE(verbose, 1, "Reload adds channel " + channelId);
+                addChannel(channelId, it.value());
+                added++;
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to reload channel " + channelId + ", it keeps its previous configuration: " + e.what());
+        }
+    }
+    setGlobalTickTime();
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    char summary[160];
+    std::snprintf(summary, sizeof(summary), "Reloaded channels in %.2f ms: %zu added, %zu removed, %zu rebuilt, %zu updated, %zu unchanged",
+                  elapsedMs, added, removed, rebuilt, updated, unchanged);
+    ProjectPrinter printer;
+    printer.Print(summary);
+}
+
+void DataChannelManager::updateChannel(const std::string& channelId, const nlohmann::json& channelConfig) {
+    DataChannel& channel = channels.at(channelId);
+    channel.setEventsBeforeBreak(channelConfig.value("publishes-per-batch", DEFAULT_PUBLISHES_PER_BATCH));
+    channel.setEventsToIgnoreInBreak(channelConfig.value("publishes-ignored-after-batch", DEFAULT_PUBLISHES_IGNORED_AFTER_BATCH));
+    applyChannelSettings(channelId, channel, channelConfig);
+
+    size_t numEvents = channelConfig.value("num-events-in-circular-buffer", static_cast<size_t>(DEFAULT_EVENTS_IN_CIRCULAR_BUFFER));
+    if (numEvents != channel.getDataBuffer().Capacity()) {
+        channel.resizeDataBuffer(numEvents);
+    }
+
+    // Processors are only updated if the rest of their configuration is unchanged, so they line up
+    if (channelConfig.contains("processors")) {
+        std::vector<int> periods = channel.getProcessorPeriods();
+        size_t index = 0;
+        for (const auto& processorConfig : channelConfig["processors"]) {
+            int periodMs = processorConfig.value("period-ms", DEFAULT_PERIOD_MS);
+            if (index < periods.size() && periods[index] != periodMs) {
+                channel.setProcessorPeriod(index, periodMs);
+            }
+            index++;
+        }
+    }
+
+    channelConfigs[channelId] = channelConfig;
+    scheduler.schedule(channelId, channel.getNextDeadline());
+}
+
+void DataChannelManager::rebuildChannel(const std::string& channelId, const nlohmann::json& channelConfig) {
+    // The transmitter and the metrics outlive the channel, so the socket stays bound and
+    // counters continue if the name and address are unchanged
+    // The copy keeps the previous processors alive until they are stopped below
+    DataChannel previousChannel = channels.at(channelId);
+    auto previousConfig = channelConfigs.find(channelId);
+    std::optional<nlohmann::json> previousChannelConfig;
+    if (previousConfig != channelConfigs.end()) {
+        previousChannelConfig = previousConfig->second;
+    }
+    channels.erase(channelId);
+    channelConfigs.erase(channelId);
+    scheduler.remove(channelId);
+
+    try {
+        addChannel(channelId, channelConfig);
+    } catch (...) {
+        channels[channelId] = previousChannel;
+        if (previousChannelConfig) {
+            channelConfigs[channelId] = *previousChannelConfig;
+        }
+        scheduler.schedule(channelId, previousChannel.getNextDeadline());
+        throw;
+    }
+
+    previousChannel.stopProcesses();
+    latencySnapshots.erase(channelId);
 }
 
 bool DataChannelManager::removeChannel(const std::string& channelId) {
     auto it = channels.find(channelId);
     if (it != channels.end()) {
+        it->second.stopProcesses();
         channels.erase(it);
+        channelConfigs.erase(channelId);
+        scheduler.remove(channelId);
+        latencySnapshots.erase(channelId);
+        MetricsRegistry::Instance().removeChannel(channelId);
         return true; // Channel removed successfully
     }
     return false; // Channel not found
@@ -209,3 +548,130 @@ void DataChannelManager::setGlobalTickTime() {
     }
 }
 
+void DataChannelManager::logStageLatencies() {
+    ProjectPrinter printer;
+    for (const auto& channelPair : channels) {
+        ChannelMetrics* metrics = channelPair.second.getMetrics();
+        if (!metrics) {
+            continue;
+        }
+        auto& previous = latencySnapshots[channelPair.first];
+        std::string summary;
+        uint64_t publishes = 0;
+        for (size_t i = 0; i < static_cast<size_t>(PublishStage::Count); ++i) {
+            HistogramSnapshot snapshot = metrics->stageLatencies[i].TakeSnapshot();
+            HistogramSnapshot interval = snapshot.Since(previous[i]);
+            previous[i] = snapshot;
+            publishes = std::max(publishes, interval.count);
+
+            char stageSummary[128];
+            std::snprintf(stageSummary, sizeof(stageSummary), " %s %.1f/%.1f/%.1f", ChannelMetrics::GetStageName(static_cast<PublishStage>(i)),
+                          interval.GetPercentile(50) / 1000.0, interval.GetPercentile(99) / 1000.0, interval.GetMax() / 1000.0);
+            summary += stageSummary;
+        }
+        if (publishes > 0) {
+            printer.Print("Channel " + channelPair.first + " stage latency p50/p99/max us:" + summary);
+        }
+    }
+}
+
+/**
+ * @brief Reads a positive integer from a control request.
+ * @param request The control request.
+ * @param key The key of the value.
+ * @return The value.
+ * @throws std::runtime_error if the value is missing, not an integer or not positive.
+ */
+static int getPositiveValue(const nlohmann::json& request, const std::string& key) {
+    if (!request.contains(key) || !request[key].is_number_integer() || request[key].get<int>() <= 0) {
+        throw std::runtime_error("Request needs a positive integer " + key);
+    }
+    return request[key].get<int>();
+}
+
+nlohmann::json DataChannelManager::handleControlRequest(const nlohmann::json& request) {
+    std::string command = request.value("command", "");
+    if (command == "list") {
+        std::vector<std::string> channelIds;
+        for (const auto& channelPair : channels) {
+            channelIds.push_back(channelPair.first);
+        }
+        return {{"ok", true}, {"channels", channelIds}};
+    }
+
+    if (command == "stats" && !request.contains("channel")) {
+        nlohmann::json channelStates = nlohmann::json::object();
+        for (const auto& channelPair : channels) {
+            channelStates[channelPair.first] = describeChannel(channelPair.second);
+        }
+        return {{"ok", true}, {"channels", channelStates}};
+    }
+
+    std::string channelId = request.value("channel", "");
+    DataChannel* channel = getChannel(channelId);
+    if (!channel) {
+        throw std::runtime_error("Unknown channel " + channelId);
+    }
+
+    ProjectPrinter printer;
+    if (command == "pause" || command == "resume") {
+        channel->setPaused(command == "pause");
+        // A paused channel has no deadline, a resumed one catches up right away
+        scheduler.schedule(channelId, channel->isPaused() ? channel->getNextDeadline() : std::chrono::steady_clock::now());
+        printer.Print("Channel " + channelId + (channel->isPaused() ? " paused" : " resumed") + " by control request.");
+    } else if (command == "set-period") {
+        int periodMs = getPositiveValue(request, "period-ms");
+        size_t numProcessors = channel->getProcessorPeriods().size();
+        if (request.contains("processor")) {
+            if (!request["processor"].is_number_unsigned() || !channel->setProcessorPeriod(request["processor"].get<size_t>(), periodMs)) {
+                throw std::runtime_error("Channel " + channelId + " has " + std::to_string(numProcessors) + " processors, no processor " + request["processor"].dump());
+            }
+        } else {
+            for (size_t i = 0; i < numProcessors; ++i) {
+                channel->setProcessorPeriod(i, periodMs);
+            }
+        }
+        scheduler.schedule(channelId, channel->getNextDeadline());
+        setGlobalTickTime();
+        printer.Print("Channel " + channelId + " processor period set to " + std::to_string(periodMs) + "ms by control request.");
+    } else if (command == "resize-buffer") {
+        int numEvents = getPositiveValue(request, "num-events-in-circular-buffer");
+        channel->resizeDataBuffer(static_cast<size_t>(numEvents));
+        printer.Print("Channel " + channelId + " circular buffer resized to " + std::to_string(numEvents) + " events by control request.");
+    } else if (command != "stats") {
+        throw std::runtime_error("Unknown command " + command);
+    }
+
+    return {{"ok", true}, {"channels", {{channelId, describeChannel(*channel)}}}};
+}
+
+nlohmann::json DataChannelManager::describeChannel(const DataChannel& channel) const {
+    const DataBuffer<std::string>& dataBuffer = channel.getDataBuffer();
+    nlohmann::json state = {
+        {"name", channel.getName()},
+        {"zmq-address", channel.getAddress()},
+        {"paused", channel.isPaused()},
+        {"suspended", channel.isSuspended()},
+        {"on-break", channel.isOnBreak()},
+        {"period-ms", channel.getProcessorPeriods()},
+        {"num-events-in-circular-buffer", dataBuffer.Capacity()},
+        {"buffered-events", dataBuffer.Size()},
+        {"last-sequence", dataBuffer.GetLastSequence()},
+        {"message-sequence", channel.getMessageSequence()}
+    };
+
+    if (ChannelMetrics* metrics = channel.getMetrics()) {
+        state["metrics"] = {
+            {"publishes", metrics->publishes.load(std::memory_order_relaxed)},
+            {"published-bytes", metrics->publishedBytes.load(std::memory_order_relaxed)},
+            {"uncompressed-bytes", metrics->uncompressedBytes.load(std::memory_order_relaxed)},
+            {"drops", metrics->drops.load(std::memory_order_relaxed)},
+            {"failures", metrics->failures.load(std::memory_order_relaxed)},
+            {"breaks", metrics->breaks.load(std::memory_order_relaxed)},
+            {"ignored-publishes", metrics->ignoredPublishes.load(std::memory_order_relaxed)},
+            {"processor-runs", metrics->processorRuns.load(std::memory_order_relaxed)},
+            {"processor-run-ms", metrics->processorRunNs.load(std::memory_order_relaxed) / 1e6}
+        };
+    }
+    return state;
+}
@@ -4,14 +4,24 @@
 
 #include <string>
 #include <map>
+#include <chrono>
+#include <memory>
+#include <array>
 #include <nlohmann/json.hpp>
 #include "DataChannel.h"
+#include "ChannelScheduler.h"
+#include "DataTransmitter.h"
+#include "ThreadPool.h"
 
 /**
  * @brief Manages data channels and their configuration.
  *
  * The `DataChannelManager` class is responsible for managing data channels,
  * providing access to individual channels, and coordinating their publication.
+ * @details Due channels run one after the other on the calling thread, or concurrently on a
+ * worker thread pool when more than one worker thread is configured. In both cases a call to
+ * \ref publishDue returns only after all due channels have been published, so everything else
+ * (scheduling, subscriptions, command output) stays on the main thread.
  */
 class DataChannelManager {
 public:
@@ -30,6 +40,35 @@ public:
      */
     bool publish();
 
+    /**
+     * @brief Sets the number of worker threads that publish due channels concurrently.
+     * @param numThreads Number of worker threads, 0 or 1 publishes on the calling thread.
+     */
+    void setWorkerThreads(size_t numThreads);
+
+    /**
+     * @brief Publishes only the data channels whose deadlines have passed.
+     * @return True if successful (though success doesn't necessarily mean data was published),
+     * false otherwise.
+     * @details Each published channel is rescheduled at the earliest next processing time
+     * of its processors.
+     * @see ChannelScheduler
+     */
+    bool publishDue();
+
+    /**
+     * @brief Gets the time at which the next data channel is due.
+     * @return The earliest deadline of all channels, or time_point::max() if there are none.
+     */
+    std::chrono::steady_clock::time_point getNextDeadline();
+
+    /**
+     * @brief Reads new subscriptions of all transmitters and wakes up channels that gained subscribers.
+     * @details Channels that gain a subscriber publish a snapshot right away,
+     * channels configured to suspend without subscribers stop working once they lose the last one.
+     */
+    void updateSubscriptions();
+
     /**
      * @brief Gets a pointer to a specific data channel by ID.
      * @param channelId The ID of the data channel to retrieve.
@@ -63,6 +102,18 @@ public:
      */
     void addChannel(const std::string& channelId, const nlohmann::json& channelConfig);
 
+    /**
+     * @brief Applies a reloaded configuration, only touching the channels that changed.
+     * @param channelConfig The new "data-channels" configuration.
+     * @details Channels whose configuration is unchanged keep running untouched. Channels that
+     * only changed settings in UPDATABLE_CHANNEL_SETTINGS or processor periods are updated in
+     * place and keep their buffers. Other changed channels are rebuilt, new and removed ones are
+     * added and removed. Transmitters are never closed, so every socket stays bound and
+     * subscribers stay connected. A channel that fails to reload keeps running as it was.
+     * Must be called from the thread calling \ref publishDue, between two calls.
+     */
+    void reloadChannels(const nlohmann::json& channelConfig);
+
     /**
      * @brief Removes a data channel from the manager.
      * @param channelId The ID of the data channel to remove.
@@ -87,10 +138,88 @@ public:
      */
     void setGlobalTickTime(int tickTime);
 
+    /**
+     * @brief Prints the publish stage latencies of every channel since the last call.
+     * @details Prints p50, p99 and max of each stage from the channels' latency histograms,
+     * channels that did not publish in the interval are left out.
+     * @see ChannelMetrics::stageLatencies
+     */
+    void logStageLatencies();
+
+    /**
+     * @brief Applies a runtime control request to the data channels.
+     * @param request JSON object with a "command" and, except for "list" and "stats", a "channel" ID.
+     * Commands are "list", "stats" (optionally for one channel), "pause", "resume",
+     * "set-period" with "period-ms" and an optional "processor" index (all processors
+     * otherwise) and "resize-buffer" with "num-events-in-circular-buffer".
+     * @return Reply with "ok": true and the state of the affected channels.
+     * @throws std::runtime_error if the command, the channel or a value is invalid.
+     * @details Must be called from the thread calling \ref publishDue, between two calls, so
+     * no channel is publishing while it changes. Changed channels are rescheduled right away.
+     * @see ControlSocket
+     */
+    nlohmann::json handleControlRequest(const nlohmann::json& request);
+
 private:
     std::map<std::string, DataChannel> channels; ///< Map of data channels.
+    std::map<std::string, nlohmann::json> channelConfigs; ///< Configuration each channel was added with, for reloads.
+    ChannelScheduler scheduler; ///< Deadlines of the data channels.
     int globalTickTime; ///< Global tick time for data channel publication.
     int verbose; ///< Verbosity level for logging.
+    std::unique_ptr<ThreadPool> workerPool; ///< Worker threads publishing due channels, null to publish serially.
+    std::map<std::string, std::array<HistogramSnapshot, static_cast<size_t>(PublishStage::Count)>> latencySnapshots; ///< Stage latencies at the last \ref logStageLatencies.
+
+    /**
+     * @brief Publishes a single data channel and reports failures.
+     * @param channelId The ID of the data channel.
+     * @param channel The data channel to publish.
+     * @return True if successful, false otherwise.
+     */
+    bool publishChannel(const std::string& channelId, DataChannel& channel);
+
+    /**
+     * @brief Publishes a set of data channels, on the worker threads if there are any.
+     * @param channelIds The IDs of the data channels to publish.
+     * @return True if all were successful, false otherwise.
+     */
+    bool publishChannels(const std::vector<std::string>& channelIds);
+
+    /**
+     * @brief Reads the socket options of a data channel from its configuration.
+     * @param optionsConfig The "socket-options" object of the channel.
+     * @return The socket options, with unset options left empty.
+     */
+    SocketOptions parseSocketOptions(const nlohmann::json& optionsConfig) const;
+
+    /**
+     * @brief Applies the optional settings of a data channel that can change while it runs.
+     * @param channelId The ID of the data channel.
+     * @param dataChannel The data channel.
+     * @param channelConfig JSON configuration of the data channel.
+     */
+    void applyChannelSettings(const std::string& channelId, DataChannel& dataChannel, const nlohmann::json& channelConfig);
+
+    /**
+     * @brief Applies a changed configuration to a running data channel, keeping its buffer.
+     * @param channelId The ID of the data channel.
+     * @param channelConfig JSON configuration that only differs in updatable settings.
+     */
+    void updateChannel(const std::string& channelId, const nlohmann::json& channelConfig);
+
+    /**
+     * @brief Replaces a data channel with one built from a changed configuration.
+     * @param channelId The ID of the data channel.
+     * @param channelConfig JSON configuration of the data channel.
+     * @throws std::exception if the new channel cannot be built, the old one is kept then.
+     */
+    void rebuildChannel(const std::string& channelId, const nlohmann::json& channelConfig);
+
+    /**
+     * @brief Describes the runtime state and counters of a data channel for control replies.
+     * @param channel The data channel.
+     * @return JSON object with the settings that can be changed at runtime and the metrics.
+     */
+    nlohmann::json describeChannel(const DataChannel& channel) const;
 };
 
 #endif // DATA_CHANNEL_MANAGER_H
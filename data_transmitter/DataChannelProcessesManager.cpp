@@ -1,35 +1,121 @@
 #include "DataChannelProcessesManager.h"
 #include "ProjectPrinter.h"
+#include "TraceRecorder.h"
 #include <algorithm> // Include for std::gcd
 
 const int DEFAULT_PROCESSOR_PERIOD = 1000;
+static const std::string NO_CHANNEL_ID = "";
 
 DataChannelProcessesManager::DataChannelProcessesManager(size_t bufferSize, int verbose)
     : dataBuffer(bufferSize), verbose(verbose), processorPeriodsGcd(DEFAULT_PROCESSOR_PERIOD) {
 }
 
-void DataChannelProcessesManager::addProcessor(GeneralProcessor* processor) {
-    processors.push_back(processor);
+void DataChannelProcessesManager::addProcessor(std::shared_ptr<GeneralProcessor> processor) {
+    processors.push_back(std::move(processor));
 }
 
 bool DataChannelProcessesManager::runProcesses() {
     bool addedNewData = false;
-    for (const auto processor : processors) {
+    for (const auto& processor : processors) {
         if (processor->isReadyToProcess()) {
-            std::vector<std::string> processedOutput = processor->getProcessedOutput();
+            auto startTime = metrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            std::vector<std::string> processedOutput;
+            {
+                TraceScope traceScope("getProcessedOutput", "processor", metrics ? metrics->channelId : NO_CHANNEL_ID);
+                processedOutput = processor->getProcessedOutput();
+            }
+            auto processTime = std::chrono::steady_clock::now();
+            processor->setLastProcessTime(processTime);
+            if (metrics) {
+                ChannelMetrics::add(metrics->processorRuns);
+                ChannelMetrics::add(metrics->processorRunNs, std::chrono::duration_cast<std::chrono::nanoseconds>(processTime - startTime).count());
+            }
             for (const auto& output : processedOutput) {
                 addedNewData = true;
                 dataBuffer.Push(output);
             }
         }
     }
+    if (addedNewData && metrics) {
+        metrics->bufferedEntries.store(dataBuffer.Size(), std::memory_order_relaxed);
+    }
     return addedNewData;
 }
 
+bool DataChannelProcessesManager::skipProcesses() {
+    bool anyDue = false;
+    for (const auto& processor : processors) {
+        if (processor->isReadyToProcess()) {
+            processor->skipProcessing();
+            processor->setLastProcessTime(std::chrono::steady_clock::now());
+            anyDue = true;
+        }
+    }
+    return anyDue;
+}
+
 const DataBuffer<std::string>& DataChannelProcessesManager::getDataBuffer() const {
     return dataBuffer;
 }
 
+void DataChannelProcessesManager::stopProcessors() {
+    for (const auto& processor : processors) {
+        processor->setReadyCallback(nullptr);
+        processor->stop();
+    }
+}
+
+void DataChannelProcessesManager::resizeDataBuffer(size_t numEvents) {
+    // The circular buffer keeps one slot free, as in the constructor call
+    dataBuffer.Resize(numEvents + 1);
+    if (metrics) {
+        metrics->bufferedEntries.store(dataBuffer.Size(), std::memory_order_relaxed);
+    }
+}
+
+std::vector<int> DataChannelProcessesManager::getProcessorPeriods() const {
+    std::vector<int> periods;
+    for (const auto& processor : processors) {
+        periods.push_back(processor->getPeriod());
+    }
+    return periods;
+}
+
+bool DataChannelProcessesManager::setProcessorPeriod(size_t index, int periodMs) {
+    if (index >= processors.size()) {
+        return false;
+    }
+    processors[index]->setPeriod(periodMs);
+    return true;
+}
+
+void DataChannelProcessesManager::setMetrics(std::shared_ptr<ChannelMetrics> channelMetrics) {
+    metrics = channelMetrics;
+}
+
+void DataChannelProcessesManager::setSerializationFormat(SerializationFormat format) {
+    dataBuffer.SetFormat(format);
+}
+
+std::chrono::steady_clock::time_point DataChannelProcessesManager::getNextProcessTime() const {
+    if (processors.empty()) {
+        return std::chrono::steady_clock::now() + std::chrono::milliseconds(DEFAULT_PROCESSOR_PERIOD);
+    }
+
+    std::chrono::steady_clock::time_point nextProcessTime = processors[0]->getNextProcessTime();
+    for (size_t i = 1; i < processors.size(); ++i) {
+        nextProcessTime = std::min(nextProcessTime, processors[i]->getNextProcessTime());
+    }
+
+    return nextProcessTime;
+}
+
+void DataChannelProcessesManager::setReadyCallback(const std::function<void()>& callback) {
+    for (const auto& processor : processors) {
+        processor->setReadyCallback(callback);
+    }
+}
+
 // Update the processorPeriodsGcd member variable
 void DataChannelProcessesManager::updateProcessorPeriodsGCD() {
     processorPeriodsGcd = findGCDOfProcessorPeriods();
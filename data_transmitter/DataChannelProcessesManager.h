@@ -4,8 +4,11 @@
 
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <functional>
 #include "GeneralProcessor.h"
 #include "DataBuffer.h"
+#include "MetricsRegistry.h"
 
 /**
  * @brief Manages data channel processors and their execution.
@@ -25,11 +28,11 @@ public:
 
     /**
      * @brief Adds a data channel processor to the manager.
-     * @param processor Pointer to the GeneralProcessor to add.
+     * @param processor The GeneralProcessor to add, shared by copies of the manager.
      * @details This is automatically done based on the config.
      * @see DataChannelManager::addChannel
      */
-    void addProcessor(GeneralProcessor* processor);
+    void addProcessor(std::shared_ptr<GeneralProcessor> processor);
 
     /**
      * @brief Runs all registered processors and adds their output to the data buffer.
@@ -37,12 +40,56 @@ public:
      */
     bool runProcesses();
 
+    /**
+     * @brief Lets every due processor skip its processing.
+     * @return True if at least one processor was due, false otherwise.
+     * @details The processors are rescheduled as if they had run, but nothing is executed
+     * and the data buffer is left unchanged.
+     */
+    bool skipProcesses();
+
     /**
      * @brief Gets the data buffer.
      * @return Reference to the data buffer.
      */
     const DataBuffer<std::string>& getDataBuffer() const;
 
+    /**
+     * @brief Sets the format the data buffer is serialized in.
+     * @param format The serialization format.
+     */
+    void setSerializationFormat(SerializationFormat format);
+
+    /**
+     * @brief Stops the background work of every processor and detaches their ready callbacks.
+     * @details Called when the data channel is removed, the processors are not run again and
+     * are freed once the last copy of the data channel is gone.
+     * @see GeneralProcessor::stop
+     */
+    void stopProcessors();
+
+    /**
+     * @brief Changes how many entries the data buffer holds.
+     * @param numEvents Number of entries, at least 1.
+     * @details The newest entries are kept, see \ref DataBuffer::Resize.
+     */
+    void resizeDataBuffer(size_t numEvents);
+
+    /**
+     * @brief Gets the periods of all processors.
+     * @return The period of every processor in milliseconds, in the order they were added.
+     */
+    std::vector<int> getProcessorPeriods() const;
+
+    /**
+     * @brief Changes the period of a processor.
+     * @param index Index of the processor, in the order they were added.
+     * @param periodMs The new period in milliseconds.
+     * @return True if the processor exists, false otherwise.
+     * @details Call \ref updateProcessorPeriodsGCD afterwards.
+     */
+    bool setProcessorPeriod(size_t index, int periodMs);
+
     /**
      * @brief Updates the greatest common divisor (GCD) of processor periods.
      * @details Used to find the a psuedo-optimal sleep time between publishes.
@@ -55,11 +102,32 @@ public:
      */
     int getProcessorPeriodsGCD() const;
 
+    /**
+     * @brief Gets the earliest time at which any of the processors is due.
+     * @return The earliest next processing time of all processors.
+     * @details If there are no processors, the default processor period from now is returned.
+     */
+    std::chrono::steady_clock::time_point getNextProcessTime() const;
+
+    /**
+     * @brief Sets the ready callback of every processor.
+     * @param callback Function that reschedules the data channel.
+     * @see GeneralProcessor::setReadyCallback
+     */
+    void setReadyCallback(const std::function<void()>& callback);
+
+    /**
+     * @brief Sets the counters processor runs are reported to.
+     * @param channelMetrics The counters of the data channel, null to not report.
+     */
+    void setMetrics(std::shared_ptr<ChannelMetrics> channelMetrics);
+
 private:
-    std::vector<GeneralProcessor*> processors; ///< Collection of data channel processors.
+    std::vector<std::shared_ptr<GeneralProcessor>> processors; ///< Collection of data channel processors, freed with the last copy of the manager.
     DataBuffer<std::string> dataBuffer; ///< Data buffer to store processor output.
     int verbose; ///< Verbosity level for printout and logging.
     int processorPeriodsGcd; ///< Greatest common divisor (GCD) of processor periods.
+    std::shared_ptr<ChannelMetrics> metrics; ///< Counters of the data channel, null if not reported.
 
     /**
      * @brief Finds the greatest common divisor (GCD) of processor periods.
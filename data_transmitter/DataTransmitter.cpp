@@ -1,21 +1,58 @@
 #include "DataTransmitter.h"
-#include "ProjectPrinter.h"
+#include "Logging.h"
+#include "TraceRecorder.h"
+#include <stdexcept>
+#include <algorithm>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
-DataTransmitter::DataTransmitter(const std::string& zmqAddress, int verbose)
-    : context(1), publisher(context, ZMQ_PUB), zmqAddress(zmqAddress), verbose(verbose), isBoundToSocket(false) {
+// Below this size copying the payload is cheaper than the extra allocations of a zero-copy message
+const size_t ZERO_COPY_MIN_SIZE = 1024;
+
+// Longest time the sender thread sleeps, bounds how late it notices a stop without a wakeup
+const int SENDER_POLL_MS = 100;
+
+/**
+ * @brief Releases the payload reference held by ZeroMQ once a zero-copy message is sent.
+ * @param data The message data (unused, owned by the payload).
+ * @param hint The heap allocated reference to the payload.
+ */
+extern "C" void releasePayload(void* /*data*/, void* hint) {
+    delete static_cast<std::shared_ptr<const std::string>*>(hint);
+}
+
+DataTransmitter::DataTransmitter(zmq::context_t& context, const std::string& zmqAddress, int verbose)
+    : publisher(context, ZMQ_XPUB), zmqAddress(zmqAddress), verbose(verbose), isBoundToSocket(false),
+      senderThreadEnabled(false), maxQueueDepth(0), overflowPolicy(OverflowPolicy::Drop), queueDepth(0), queuedCount(0),
+      sentCount(0), droppedCount(0), sendFailureCount(0), backpressureCount(0), senderRunning(false), senderWaiting(false), blockedPublishers(0),
+      subscriptionsChanged(false), wakeFd(-1) {
     // Constructor initializes ZeroMQ socket
+    // Report every subscribe and unsubscribe, not just the first and last per topic, so they can be counted
+#ifdef ZMQ_XPUB_VERBOSER
+    publisher.set(zmq::sockopt::xpub_verboser, 1);
+#else
+    publisher.set(zmq::sockopt::xpub_verbose, 1);
+#endif
 }
 
 DataTransmitter::~DataTransmitter() {
-    // Destructor cleans up resources
+    // Destructor cleans up resources, the context is owned by the DataTransmitterManager
+    stopSenderThread();
     publisher.close();
-    context.close();
 }
 
 bool DataTransmitter::bind() {
+    std::lock_guard<std::mutex> lock(socketMutex);
+    if (isBoundToSocket) {
+        return true; // Another channel on the same address was faster
+    }
     try {
         publisher.bind(zmqAddress);
         isBoundToSocket = true;
+        // From now on only the sender thread touches the socket
+        if (senderThreadEnabled) {
+            startSenderThread();
+        }
         return true;
     } catch (const zmq::error_t& e) {
         // Handle any connection errors
@@ -29,64 +66,399 @@ bool DataTransmitter::isBound() {
 
 
 bool DataTransmitter::publish(DataChannel& dataChannel, const std::string& data) {
-    ProjectPrinter printer;
+    return publish(dataChannel, std::make_shared<const std::string>(data));
+}
+
+bool DataTransmitter::publish(DataChannel& dataChannel, std::shared_ptr<const std::string> data) {
     try {
-        std::string channel = dataChannel.getName();
+        const std::string& channel = dataChannel.getName();
         dataChannel.seen();
-        if (verbose > 0) {
-            std::string channelDetails;
-            channelDetails += "Channel Name: " + channel + "\n";
-            channelDetails += "Events Before Break: " + std::to_string(dataChannel.getEventsBeforeBreak()) + "\n";
-            channelDetails += "Events To Ignore In Break: " + std::to_string(dataChannel.getEventsToIgnoreInBreak()) + "\n";
-            channelDetails += "Events Published: " + std::to_string(dataChannel.getEventsPublished()) + "\n";
-            channelDetails += "Events Seen: " + std::to_string(dataChannel.getEventsSeen()) + "\n";
-            
-            if (dataChannel.isOnBreak()) {
-                int eventsOnBreak = dataChannel.getEventsToIgnoreInBreak() - dataChannel.getEventsSeenOnBreak();
-                channelDetails += channel + " is on a break for " + std::to_string(eventsOnBreak) + " events\n";
-            }
-            printer.Print(channelDetails);
+        if (isVerboseEnabled<1>(verbose)) {
+            printChannelDetails(dataChannel);
         }
         if (dataChannel.isOnBreak()) {
             return true;
         }
         
         
-        if (!channel.empty()) { // No topic is sent if the channel name is empty
-            // Send the channel (topic)
-            zmq::message_t channelMessage(channel.size());
-            memcpy(channelMessage.data(), channel.c_str(), channel.size());
-            publisher.send(channelMessage, zmq::send_flags::sndmore);
+        if (isSenderThreadRunning()) {
+            // A dropped message is not an error, it is published again with the next data
+            if (!enqueue({channel, dataChannel.getHeaderFrame(), data, dataChannel.getSendFailedFlag()})) {
+                if (ChannelMetrics* metrics = dataChannel.getMetrics()) {
+                    ChannelMetrics::add(metrics->drops);
+                }
+                uint64_t dropped = droppedCount.load();
+                if (isVerboseEnabled<1>(verbose) || dropped == 1) {
+                    LOG_WARNING("Send queue of address " + zmqAddress + " is full, dropped message of channel " + channel +
+                                " (" + std::to_string(dropped) + " dropped so far)");
+                }
+                return true;
+            }
+        } else {
+            sendFrames(channel, dataChannel.getHeaderFrame(), data);
         }
 
-        // Send the actual message content
-        zmq::message_t message(data.size());
-        memcpy(message.data(), data.c_str(), data.size());
-        publisher.send(message, zmq::send_flags::none);
-
+        if (ChannelMetrics* metrics = dataChannel.getMetrics()) {
+            ChannelMetrics::add(metrics->publishes);
+            ChannelMetrics::add(metrics->publishedBytes, data->size());
+        }
         dataChannel.published();
 
-        if (verbose > 2) {
-            printer.Print("Published to channel " + channel + " at address " + zmqAddress + ": " + data);
-        } else if (verbose > 1) {
-            if (data.length() > 1000) {
-                std::string truncatedData = data.substr(0, 1000);
-                printer.Print("Published to channel " + channel + " at address " + zmqAddress + ": " + truncatedData +"... <truncated> ...");
-            } else {
-                printer.Print("Published to channel " + channel + " at address " + zmqAddress + ": " + data);
-            }
-        } else if (verbose > 0) {
-            printer.Print("Published to channel " + channel + " at address " + zmqAddress);
+        if (isVerboseEnabled<1>(verbose)) {
+            printPublished(channel, *data);
         }
 
-
         return true;
     } catch (const zmq::error_t& e) {
-        printer.PrintError("Failed to send data to address " + zmqAddress, __LINE__, __FILE__);
+        LOG_ERROR("Failed to send data to address " + zmqAddress);
         return false;
     }
 }
 
+void DataTransmitter::printChannelDetails(const DataChannel& dataChannel) const {
+    const std::string& channel = dataChannel.getName();
+    std::string channelDetails;
+    channelDetails += "Channel Name: " + channel + "\n";
+    channelDetails += "Events Before Break: " + std::to_string(dataChannel.getEventsBeforeBreak()) + "\n";
+    channelDetails += "Events To Ignore In Break: " + std::to_string(dataChannel.getEventsToIgnoreInBreak()) + "\n";
+    channelDetails += "Events Published: " + std::to_string(dataChannel.getEventsPublished()) + "\n";
+    channelDetails += "Events Seen: " + std::to_string(dataChannel.getEventsSeen()) + "\n";
+
+    if (dataChannel.isOnBreak()) {
+        int eventsOnBreak = dataChannel.getEventsToIgnoreInBreak() - dataChannel.getEventsSeenOnBreak();
+        channelDetails += channel + " is on a break for " + std::to_string(eventsOnBreak) + " events\n";
+    }
+    ProjectPrinter().Print(channelDetails);
+}
+
+void DataTransmitter::printPublished(const std::string& channel, const std::string& data) const {
+    std::string message = "Published to channel " + channel + " at address " + zmqAddress;
+    if (isVerboseEnabled<3>(verbose)) {
+        message += ": " + data;
+    } else if (isVerboseEnabled<2>(verbose)) {
+        if (data.length() > 1000) {
+            message += ": " + data.substr(0, 1000) + "... <truncated> ...";
+        } else {
+            message += ": " + data;
+        }
+    }
+    ProjectPrinter().Print(message);
+}
+
+void DataTransmitter::sendFrames(const std::string& topic, const std::string& header, const std::shared_ptr<const std::string>& payload) {
+    TraceScope traceScope("send", "socket", topic);
+    std::lock_guard<std::mutex> lock(socketMutex);
+    if (!topic.empty()) { // No topic is sent if the channel name is empty
+        // Send the channel (topic)
+        zmq::message_t channelMessage;
+        channelMessage.copy(getTopicFrame(topic));
+        publisher.send(channelMessage, zmq::send_flags::sndmore);
+    }
+
+    if (!header.empty()) { // Only channels that need one send a header frame
+        zmq::message_t headerMessage(header.data(), header.size());
+        MessageHeader::StampSendTime(headerMessage.data(), headerMessage.size());
+        publisher.send(headerMessage, zmq::send_flags::sndmore);
+    }
+
+    // Send the actual message content
+    zmq::message_t message = makePayloadMessage(payload);
+    publisher.send(message, zmq::send_flags::none);
+}
+
+zmq::message_t& DataTransmitter::getTopicFrame(const std::string& channel) {
+    auto it = topicFrames.find(channel);
+    if (it == topicFrames.end()) {
+        it = topicFrames.emplace(channel, zmq::message_t(channel.data(), channel.size())).first;
+    }
+    return it->second;
+}
+
+zmq::message_t DataTransmitter::makePayloadMessage(const std::shared_ptr<const std::string>& data) {
+    if (data->size() < ZERO_COPY_MIN_SIZE) {
+        return zmq::message_t(data->data(), data->size());
+    }
+
+    // ZeroMQ only reads the payload, the extra reference keeps it alive until the message is sent
+    auto reference = std::make_unique<std::shared_ptr<const std::string>>(data);
+    zmq::message_t message(const_cast<char*>(data->data()), data->size(), releasePayload, reference.get());
+    reference.release();
+    return message;
+}
+
 void DataTransmitter::setVerbose(int verboseLevel) {
     verbose = verboseLevel;
 }
+
+template <typename T>
+bool DataTransmitter::mergeOption(std::optional<T>& current, const std::optional<T>& requested, const std::string& optionName) {
+    if (!requested) {
+        return false;
+    }
+    if (current && *current != *requested) {
+        ProjectPrinter printer;
+        printer.PrintWarning("Conflicting " + optionName + " for address " + zmqAddress + ", using " + std::to_string(*requested), __LINE__, __FILE__);
+    }
+    current = requested;
+    return true;
+}
+
+bool DataTransmitter::setSocketOptions(const SocketOptions& options) {
+    ProjectPrinter printer;
+    if (isSenderThreadRunning()) {
+        printer.PrintWarning("Socket options of address " + zmqAddress + " cannot be changed while its sender thread runs", __LINE__, __FILE__);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(socketMutex);
+    if (isBoundToSocket && (options.sendHighWaterMark || options.sendBuffer || options.immediate)) {
+        printer.PrintWarning("Socket options set after binding " + zmqAddress + " only apply to new subscribers", __LINE__, __FILE__);
+    }
+
+    try {
+        if (mergeOption(socketOptions.sendHighWaterMark, options.sendHighWaterMark, "sndhwm")) {
+            publisher.set(zmq::sockopt::sndhwm, *options.sendHighWaterMark);
+        }
+        if (mergeOption(socketOptions.sendBuffer, options.sendBuffer, "sndbuf")) {
+            publisher.set(zmq::sockopt::sndbuf, *options.sendBuffer);
+        }
+        if (mergeOption(socketOptions.immediate, options.immediate, "immediate")) {
+            publisher.set(zmq::sockopt::immediate, *options.immediate ? 1 : 0);
+        }
+        if (mergeOption(socketOptions.lingerMs, options.lingerMs, "linger-ms")) {
+            publisher.set(zmq::sockopt::linger, *options.lingerMs);
+        }
+    } catch (const zmq::error_t& e) {
+        printer.PrintError("Failed to set socket options for address " + zmqAddress + ": " + e.what(), __LINE__, __FILE__);
+        return false;
+    }
+
+    LOG_VERBOSE(verbose, 1, "Applied socket options to address " + zmqAddress);
+    return true;
+}
+
+bool DataTransmitter::enableSenderThread(size_t maxQueueDepth, OverflowPolicy policy) {
+    if (isBoundToSocket) {
+        ProjectPrinter printer;
+        printer.PrintWarning("The sender thread of address " + zmqAddress + " can only be enabled before binding", __LINE__, __FILE__);
+        return false;
+    }
+    senderThreadEnabled = true;
+    this->maxQueueDepth = std::max<size_t>(maxQueueDepth, 1);
+    overflowPolicy = policy;
+    return true;
+}
+
+bool DataTransmitter::isSenderThreadRunning() const {
+    return senderRunning.load();
+}
+
+SendQueueStats DataTransmitter::getSendQueueStats() const {
+    SendQueueStats stats;
+    stats.depth = queueDepth.load();
+    stats.queued = queuedCount.load();
+    stats.sent = sentCount.load();
+    stats.dropped = droppedCount.load();
+    stats.sendFailures = sendFailureCount.load();
+    stats.backpressureWaits = backpressureCount.load();
+    return stats;
+}
+
+DataTransmitter::OverflowPolicy DataTransmitter::parseOverflowPolicy(const std::string& name) {
+    if (name == "drop") {
+        return OverflowPolicy::Drop;
+    }
+    if (name == "block") {
+        return OverflowPolicy::Block;
+    }
+    throw std::runtime_error("Unknown send queue overflow policy: " + name);
+}
+
+bool DataTransmitter::enqueue(OutgoingMessage message) {
+    bool waited = false;
+
+    // Reserve a slot before pushing so concurrent publishers cannot overshoot the limit
+    while (queueDepth.fetch_add(1) >= maxQueueDepth) {
+        queueDepth.fetch_sub(1);
+        if (overflowPolicy == OverflowPolicy::Drop || !senderRunning.load()) {
+            droppedCount++;
+            return false;
+        }
+        if (!waited) {
+            backpressureCount++;
+            waited = true;
+        }
+        // The timeout covers a wakeup that happens between the check and the wait
+        std::unique_lock<std::mutex> lock(spaceMutex);
+        blockedPublishers++;
+        spaceAvailable.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+            return queueDepth.load() < maxQueueDepth || !senderRunning.load();
+        });
+        blockedPublishers--;
+    }
+
+    queuedCount++;
+    sendQueue.push(std::move(message));
+
+    // Only pay for the system call when the sender thread is going to sleep
+    if (senderWaiting.exchange(false)) {
+        uint64_t one = 1;
+        ssize_t written = write(wakeFd, &one, sizeof(one));
+        (void)written; // A full eventfd already wakes the sender
+    }
+    return true;
+}
+
+void DataTransmitter::startSenderThread() {
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        throw std::runtime_error("Failed to create the wakeup eventfd of the sender thread for address " + zmqAddress);
+    }
+    senderRunning = true;
+    senderThread = std::thread(&DataTransmitter::senderLoop, this);
+
+    LOG_VERBOSE(verbose, 1, "Started sender thread for address " + zmqAddress + " with a queue of " + std::to_string(maxQueueDepth) + " messages");
+}
+
+void DataTransmitter::stopSenderThread() {
+    if (!senderThread.joinable()) {
+        return;
+    }
+    senderRunning = false;
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+    spaceAvailable.notify_all();
+    senderThread.join();
+    close(wakeFd);
+    wakeFd = -1;
+}
+
+void DataTransmitter::senderLoop() {
+    while (senderRunning.load()) {
+        drainSendQueue();
+        if (readSubscriptions()) {
+            subscriptionsChanged = true;
+        }
+
+        // Announce the sleep before the last check so a publisher that pushes now wakes us
+        senderWaiting = true;
+        if (!sendQueue.empty()) {
+            senderWaiting = false;
+            continue;
+        }
+
+        // Wake up for subscriptions arriving on the socket or for new messages
+        zmq::pollitem_t items[] = {
+            {publisher.handle(), 0, ZMQ_POLLIN, 0},
+            {nullptr, wakeFd, ZMQ_POLLIN, 0}
+        };
+        try {
+            zmq::poll(items, 2, std::chrono::milliseconds(SENDER_POLL_MS));
+        } catch (const zmq::error_t& e) {
+            // Interrupted by a signal, just go around again
+        }
+        senderWaiting = false;
+
+        if (items[1].revents & ZMQ_POLLIN) {
+            uint64_t count;
+            ssize_t bytesRead = read(wakeFd, &count, sizeof(count));
+            (void)bytesRead;
+        }
+    }
+
+    // Send what is left so a clean shutdown does not lose queued messages
+    drainSendQueue();
+}
+
+void DataTransmitter::drainSendQueue() {
+    OutgoingMessage message;
+    while (sendQueue.pop(message)) {
+        queueDepth.fetch_sub(1);
+        if (blockedPublishers.load() > 0) {
+            std::lock_guard<std::mutex> lock(spaceMutex);
+            spaceAvailable.notify_all();
+        }
+
+        try {
+            sendFrames(message.topic, message.header, message.payload);
+            sentCount++;
+        } catch (const zmq::error_t& e) {
+            sendFailureCount++;
+            message.sendFailed->store(true);
+            ProjectPrinter printer;
+            printer.PrintError("Failed to send data to address " + zmqAddress, __LINE__, __FILE__);
+        }
+        message.payload.reset();
+        message.sendFailed.reset();
+    }
+}
+
+bool DataTransmitter::pollSubscriptions() {
+    if (!isBoundToSocket) {
+        return false;
+    }
+    if (isSenderThreadRunning()) {
+        return subscriptionsChanged.exchange(false);
+    }
+    return readSubscriptions();
+}
+
+bool DataTransmitter::readSubscriptions() {
+    std::lock_guard<std::mutex> socketLock(socketMutex);
+    bool changed = false;
+    try {
+        zmq::message_t message;
+        while (publisher.recv(message, zmq::recv_flags::dontwait)) {
+            // The first byte is 1 for subscribe and 0 for unsubscribe, the rest is the topic
+            if (message.size() == 0) {
+                continue;
+            }
+            const char* messageData = static_cast<const char*>(message.data());
+            std::string topic(messageData + 1, message.size() - 1);
+            std::lock_guard<std::mutex> subscriptionLock(subscriptionMutex);
+            if (messageData[0] == 1) {
+                subscriptionCounts[topic]++;
+                subscribeTotals[topic]++;
+            } else if (subscriptionCounts[topic] > 1) {
+                subscriptionCounts[topic]--;
+            } else {
+                subscriptionCounts.erase(topic);
+            }
+            changed = true;
+
+            LOG_VERBOSE(verbose, 2, std::string(messageData[0] == 1 ? "Subscription to '" : "Unsubscription from '") + topic + "' at address " + zmqAddress);
+        }
+    } catch (const zmq::error_t& e) {
+        ProjectPrinter printer;
+        printer.PrintError("Failed to read subscriptions at address " + zmqAddress, __LINE__, __FILE__);
+    }
+    return changed;
+}
+
+bool DataTransmitter::hasSubscribers(const std::string& topic) const {
+    std::lock_guard<std::mutex> lock(subscriptionMutex);
+    if (topic.empty()) {
+        return !subscriptionCounts.empty();
+    }
+    for (const auto& subscription : subscriptionCounts) {
+        if (topic.compare(0, subscription.first.size(), subscription.first) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t DataTransmitter::getSubscribeCount(const std::string& topic) const {
+    std::lock_guard<std::mutex> lock(subscriptionMutex);
+    uint64_t subscribes = 0;
+    for (const auto& subscription : subscribeTotals) {
+        if (topic.compare(0, subscription.first.size(), subscription.first) == 0) {
+            subscribes += subscription.second;
+        }
+    }
+    return subscribes;
+}
+
+const std::string& DataTransmitter::getAddress() const {
+    return zmqAddress;
+}
@@ -3,25 +3,80 @@
 #define DATATRANSMITTER_H
 
 #include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <optional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
 #include <zmq.hpp>
 #include <iostream>
 #include "ProjectPrinter.h"
 #include "DataChannel.h"
+#include "MpscQueue.h"
+
+/**
+ * @brief Options applied to a publisher socket before it is bound.
+ *
+ * Options that are not set keep the ZeroMQ default.
+ */
+struct SocketOptions {
+    std::optional<int> sendHighWaterMark; ///< ZMQ_SNDHWM, messages queued per subscriber before new ones are dropped.
+    std::optional<int> sendBuffer;        ///< ZMQ_SNDBUF, kernel send buffer size in bytes.
+    std::optional<bool> immediate;        ///< ZMQ_IMMEDIATE, only queue messages for completed connections.
+    std::optional<int> lingerMs;          ///< ZMQ_LINGER, how long unsent messages are kept when the socket closes.
+};
+
+/**
+ * @brief Counters of the send queue of a transmitter with a sender thread.
+ */
+struct SendQueueStats {
+    size_t depth = 0;               ///< Messages currently waiting in the queue.
+    uint64_t queued = 0;            ///< Messages added to the queue.
+    uint64_t sent = 0;              ///< Messages sent by the sender thread.
+    uint64_t dropped = 0;           ///< Messages dropped because the queue was full.
+    uint64_t sendFailures = 0;      ///< Messages the sender thread failed to send.
+    uint64_t backpressureWaits = 0; ///< Times a publisher had to wait for room in the queue.
+};
 
 /**
  * @brief Transmits data over a ZeroMQ (zmq) publisher socket.
  *
  * The `DataTransmitter` class provides functionality for binding to a zmq publisher socket
  * and publishing data to a specific zmq-address.
+ * @details The socket is an XPUB socket, which behaves like a PUB socket but also reports
+ * every subscribe and unsubscribe. The transmitter counts the live subscriptions per topic
+ * so channels nobody is watching can skip their work, and every subscribe so channels can
+ * send a snapshot to each new subscriber.
+ * Large payloads are handed to ZeroMQ without copying them, and the topic frame of every
+ * channel is built once and reused.
+ * With the sender thread enabled, publishing only adds the message to a lock-free queue and a
+ * dedicated thread owns the socket from the moment it is bound, so a slow socket does not
+ * stall data acquisition.
+ * Channels sharing a transmitter may publish from different worker threads; socket access is
+ * serialized by the transmitter.
  */
 class DataTransmitter {
 public:
+    /**
+     * @brief What publishing does when the send queue is full.
+     */
+    enum class OverflowPolicy {
+        Drop,  ///< Drop the new message.
+        Block  ///< Wait until the sender thread made room.
+    };
+
     /**
      * @brief Constructor for DataTransmitter.
+     * @param context The ZeroMQ context the socket is created in, it must outlive the transmitter.
      * @param zmqAddress The zmq-address to which the transmitter will bind.
      * @param verbose Verbosity level for logging (default is 0).
      */
-    DataTransmitter(const std::string& zmqAddress, int verbose = 0);
+    DataTransmitter(zmq::context_t& context, const std::string& zmqAddress, int verbose = 0);
 
     /**
      * @brief Destructor for DataTransmitter.
@@ -49,18 +104,210 @@ public:
      */
     bool publish(DataChannel& dataChannel, const std::string& data);
 
+    /**
+     * @brief Publishes shared data to the specified data channel without copying it.
+     * @param dataChannel The data channel to publish to.
+     * @param data The data to publish. ZeroMQ keeps a reference until the message is sent.
+     * @return True if successful (this does not necessarily mean data is published),
+     * false otherwise.
+     */
+    bool publish(DataChannel& dataChannel, std::shared_ptr<const std::string> data);
+
     /**
      * @brief Sets the verbosity level for logging.
      * @param enableVerbose Verbosity level to set.
      */
     void setVerbose(int enableVerbose);
 
+    /**
+     * @brief Applies socket options to the publisher socket.
+     * @param options The options to apply, unset options are left unchanged.
+     * @return True if all options were applied, false otherwise.
+     * @details Options that differ from ones set earlier (by another channel on the same
+     * address) override them with a warning. Apart from linger, options only affect
+     * connections made after they are set, so they should be applied before binding.
+     */
+    bool setSocketOptions(const SocketOptions& options);
+
+    /**
+     * @brief Makes the transmitter send from a dedicated thread fed by a queue.
+     * @param maxQueueDepth Most messages waiting in the queue.
+     * @param policy What publishing does when the queue is full.
+     * @return True if enabled, false if the transmitter is already bound.
+     * @details The thread is started when the transmitter is bound.
+     */
+    bool enableSenderThread(size_t maxQueueDepth, OverflowPolicy policy);
+
+    /**
+     * @brief Checks if the sender thread is running.
+     * @return True if messages are sent by the sender thread, false otherwise.
+     */
+    bool isSenderThreadRunning() const;
+
+    /**
+     * @brief Gets the counters of the send queue.
+     * @return The counters, all zero without a sender thread.
+     */
+    SendQueueStats getSendQueueStats() const;
+
+    /**
+     * @brief Parses a send queue overflow policy name from the config.
+     * @param name Either "drop" or "block".
+     * @return The matching policy.
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static OverflowPolicy parseOverflowPolicy(const std::string& name);
+
+    /**
+     * @brief Reads all pending subscribe and unsubscribe messages without blocking.
+     * @return True if any subscription was added or removed, false otherwise.
+     * @details With the sender thread running, the thread reads them and this only reports
+     * whether they changed since the last call.
+     */
+    bool pollSubscriptions();
+
+    /**
+     * @brief Checks if any subscriber would receive messages published on a topic.
+     * @param topic The channel name used as topic.
+     * @return True if a live subscription is a prefix of the topic, false otherwise.
+     * @details Messages of channels with an empty name have no topic frame, so they are
+     * considered watched as soon as anything is subscribed.
+     */
+    bool hasSubscribers(const std::string& topic) const;
+
+    /**
+     * @brief Gets the number of subscribe messages that match a topic.
+     * @param topic The channel name used as topic.
+     * @return Subscribes received so far for prefixes of the topic, including ones that were
+     * unsubscribed again. It only grows, so a change means somebody subscribed.
+     */
+    uint64_t getSubscribeCount(const std::string& topic) const;
+
+    /**
+     * @brief Gets the zmq-address of the transmitter.
+     * @return The zmq-address.
+     */
+    const std::string& getAddress() const;
+
 private:
-    zmq::context_t context; ///< ZeroMQ context.
-    zmq::socket_t publisher; ///< ZeroMQ publisher socket.
+    zmq::socket_t publisher; ///< ZeroMQ XPUB publisher socket.
     std::string zmqAddress; ///< The zmq-address to which the transmitter is bound.
     int verbose; ///< Verbosity level for logging.
-    bool isBoundToSocket; ///< Flag indicating if the transmitter is bound to the zmq publisher socket.
+    std::atomic<bool> isBoundToSocket; ///< Flag indicating if the transmitter is bound to the zmq publisher socket.
+    std::mutex socketMutex; ///< Serializes socket use by channels publishing from different threads.
+    std::map<std::string, int> subscriptionCounts; ///< Number of live subscriptions per topic prefix.
+    std::map<std::string, uint64_t> subscribeTotals; ///< Number of subscribes ever received per topic prefix.
+    SocketOptions socketOptions; ///< Options applied to the publisher socket so far.
+    std::unordered_map<std::string, zmq::message_t> topicFrames; ///< Prebuilt topic frame of every channel name.
+
+    /**
+     * @brief Gets the prebuilt topic frame of a channel, building it on first use.
+     * @param channel The channel name.
+     * @return Reference to the topic frame, to be copied into the message that is sent.
+     */
+    zmq::message_t& getTopicFrame(const std::string& channel);
+
+    /**
+     * @brief Wraps a payload in a message.
+     * @param data The payload.
+     * @return A message that references the payload, or a copy of it for small payloads.
+     */
+    static zmq::message_t makePayloadMessage(const std::shared_ptr<const std::string>& data);
+
+    /**
+     * @brief Records a socket option, warning if it overrides a different earlier value.
+     * @param current The option recorded so far.
+     * @param requested The requested option value.
+     * @param optionName Name of the option used in the warning.
+     * @return True if the option has to be applied to the socket, false otherwise.
+     */
+    template <typename T>
+    bool mergeOption(std::optional<T>& current, const std::optional<T>& requested, const std::string& optionName);
+
+    /**
+     * @brief A message waiting in the send queue.
+     */
+    struct OutgoingMessage {
+        std::string topic;                           ///< The channel name, empty for no topic frame.
+        std::string header;                          ///< The encoded message header, empty for no header frame.
+        std::shared_ptr<const std::string> payload;  ///< The data to publish.
+        std::shared_ptr<std::atomic<bool>> sendFailed; ///< Flag of the channel, set if the message could not be sent.
+    };
+
+    bool senderThreadEnabled; ///< Flag indicating messages are sent by the sender thread once bound.
+    size_t maxQueueDepth; ///< Most messages waiting in the send queue.
+    OverflowPolicy overflowPolicy; ///< What publishing does when the send queue is full.
+    MpscQueue<OutgoingMessage> sendQueue; ///< Messages waiting for the sender thread.
+    std::atomic<size_t> queueDepth; ///< Messages in the send queue, reserved before pushing.
+    std::atomic<uint64_t> queuedCount; ///< Messages added to the send queue.
+    std::atomic<uint64_t> sentCount; ///< Messages sent by the sender thread.
+    std::atomic<uint64_t> droppedCount; ///< Messages dropped because the send queue was full.
+    std::atomic<uint64_t> sendFailureCount; ///< Messages the sender thread failed to send.
+    std::atomic<uint64_t> backpressureCount; ///< Times a publisher waited for room in the send queue.
+    std::atomic<bool> senderRunning; ///< Flag telling the sender thread to keep running.
+    std::atomic<bool> senderWaiting; ///< Flag indicating the sender thread is about to sleep and needs a wakeup.
+    std::atomic<int> blockedPublishers; ///< Publishers waiting for room in the send queue.
+    std::mutex spaceMutex; ///< Protects waiting for room in the send queue.
+    std::condition_variable spaceAvailable; ///< Signalled when the sender thread takes a message.
+    mutable std::mutex subscriptionMutex; ///< Protects subscriptionCounts and subscribeTotals while the sender thread runs.
+    std::atomic<bool> subscriptionsChanged; ///< Flag set by the sender thread when subscriptions changed.
+    int wakeFd; ///< Eventfd used to wake up the sender thread.
+    std::thread senderThread; ///< The thread that owns the socket once bound.
+
+    /**
+     * @brief Sends the topic frame, header frame and payload on the socket.
+     * @param topic The channel name, empty for no topic frame.
+     * @param header The encoded message header, empty for no header frame.
+     * @param payload The data to publish.
+     * @throws zmq::error_t if sending fails.
+     */
+    void sendFrames(const std::string& topic, const std::string& header, const std::shared_ptr<const std::string>& payload);
+
+    /**
+     * @brief Prints the publishing counters and break state of a channel.
+     * @param dataChannel The channel to describe.
+     */
+    void printChannelDetails(const DataChannel& dataChannel) const;
+
+    /**
+     * @brief Prints a published message, with its data from verbose level 2 on.
+     * @param channel The channel name.
+     * @param data The published data, truncated at verbose level 2.
+     */
+    void printPublished(const std::string& channel, const std::string& data) const;
+
+    /**
+     * @brief Reads all pending subscribe and unsubscribe messages from the socket.
+     * @return True if any subscription was added or removed, false otherwise.
+     */
+    bool readSubscriptions();
+
+    /**
+     * @brief Adds a message to the send queue, applying the overflow policy.
+     * @param message The message to add.
+     * @return True if the message was queued, false if it was dropped.
+     */
+    bool enqueue(OutgoingMessage message);
+
+    /**
+     * @brief Starts the sender thread, which takes over the socket.
+     */
+    void startSenderThread();
+
+    /**
+     * @brief Stops the sender thread after it sent the remaining messages.
+     */
+    void stopSenderThread();
+
+    /**
+     * @brief Sends queued messages and reads subscriptions until stopped.
+     */
+    void senderLoop();
+
+    /**
+     * @brief Sends the queued messages that are ready.
+     */
+    void drainSendQueue();
 };
 
 #endif // DATATRANSMITTER_H
@@ -1,6 +1,10 @@
 #include "DataTransmitterManager.h"
+#include "Logging.h"
+#include "MetricsRegistry.h"
 
-DataTransmitterManager::DataTransmitterManager(int verbose) : verbose(verbose) {}
+DataTransmitterManager::DataTransmitterManager(int verbose)
+    : verbose(verbose), context(1), senderThreadsEnabled(false), sendQueueDepth(0),
+      sendQueueOverflowPolicy(DataTransmitter::OverflowPolicy::Drop) {}
 
 DataTransmitterManager& DataTransmitterManager::Instance(int verbose) {
     static DataTransmitterManager instance(verbose);
@@ -13,12 +17,17 @@ DataTransmitterManager::~DataTransmitterManager() {
 
 void DataTransmitterManager::addZmqAddress(const std::string& zmqAddress) {
     if (transmitterMap.find(zmqAddress) == transmitterMap.end()) {
-        transmitterMap[zmqAddress] = std::make_shared<DataTransmitter>(zmqAddress, verbose);
+        transmitterMap[zmqAddress] = std::make_shared<DataTransmitter>(context, zmqAddress, verbose);
+        if (senderThreadsEnabled) {
+            transmitterMap[zmqAddress]->enableSenderThread(sendQueueDepth, sendQueueOverflowPolicy);
+        }
+        MetricsRegistry::Instance().registerTransmitter(zmqAddress, transmitterMap[zmqAddress]);
     }
 }
 
 void DataTransmitterManager::setZmqAddress(const std::string& zmqAddress, std::shared_ptr<DataTransmitter> transmitter) {
     transmitterMap[zmqAddress] = transmitter;
+    MetricsRegistry::Instance().registerTransmitter(zmqAddress, transmitter);
 }
 
 std::shared_ptr<DataTransmitter> DataTransmitterManager::getTransmitter(const std::string& zmqAddress) {
@@ -33,3 +42,62 @@ std::shared_ptr<DataTransmitter> DataTransmitterManager::getTransmitter(const st
 void DataTransmitterManager::setVerbose(int enableVerbose) {
     verbose = enableVerbose;
 }
+
+bool DataTransmitterManager::pollSubscriptions() {
+    bool changed = false;
+    for (auto& transmitterPair : transmitterMap) {
+        std::shared_ptr<DataTransmitter>& transmitter = transmitterPair.second;
+        // Bind early so subscribers can connect before the first publish
+        if (!transmitter->isBound()) {
+            transmitter->bind();
+        }
+        if (transmitter->pollSubscriptions()) {
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool DataTransmitterManager::setIoThreads(int ioThreads) {
+    ProjectPrinter printer;
+    if (ioThreads < 1) {
+        printer.PrintWarning("Invalid number of I/O threads " + std::to_string(ioThreads) + ", keeping the current setting", __LINE__, __FILE__);
+        return false;
+    }
+    if (!transmitterMap.empty()) {
+        printer.PrintWarning("I/O threads can only be set before the first transmitter is created", __LINE__, __FILE__);
+        return false;
+    }
+
+    try {
+        context.set(zmq::ctxopt::io_threads, ioThreads);
+    } catch (const zmq::error_t& e) {
+        printer.PrintError("Failed to set the number of I/O threads: " + std::string(e.what()), __LINE__, __FILE__);
+        return false;
+    }
+
+    LOG_VERBOSE(verbose, 1, "Using " + std::to_string(ioThreads) + " ZeroMQ I/O thread(s)");
+    return true;
+}
+
+void DataTransmitterManager::setSenderThreads(bool enabled, size_t maxQueueDepth, DataTransmitter::OverflowPolicy policy) {
+    senderThreadsEnabled = enabled;
+    sendQueueDepth = maxQueueDepth;
+    sendQueueOverflowPolicy = policy;
+    if (!enabled) {
+        return;
+    }
+    for (auto& transmitterPair : transmitterMap) {
+        if (!transmitterPair.second->isBound()) {
+            transmitterPair.second->enableSenderThread(maxQueueDepth, policy);
+        }
+    }
+}
+
+bool DataTransmitterManager::setSocketOptions(const std::string& zmqAddress, const SocketOptions& options) {
+    return getTransmitter(zmqAddress)->setSocketOptions(options);
+}
+
+zmq::context_t& DataTransmitterManager::getContext() {
+    return context;
+}
@@ -14,6 +14,8 @@
  *
  * The `DataTransmitterManager` class is responsible for managing and providing access to
  * data transmitters associated with specific zmq-addresses. It is designed as a singleton.
+ * @details All transmitters share the single ZeroMQ context owned by the manager, so the
+ * number of ZeroMQ I/O threads does not grow with the number of addresses.
  */
 class DataTransmitterManager {
 public:
@@ -59,6 +61,43 @@ public:
      */
     void setVerbose(int enableVerbose);
 
+    /**
+     * @brief Sets the number of ZeroMQ I/O threads of the shared context.
+     * @param ioThreads Number of I/O threads, must be at least 1.
+     * @return True if the setting was applied, false otherwise.
+     * @details Only takes effect before the first transmitter is created.
+     */
+    bool setIoThreads(int ioThreads);
+
+    /**
+     * @brief Makes every transmitter send from a dedicated thread fed by a queue.
+     * @param enabled Flag to enable the sender threads.
+     * @param maxQueueDepth Most messages waiting in the queue of each transmitter.
+     * @param policy What publishing does when a queue is full.
+     * @details Applies to transmitters created afterwards and to existing ones that are not bound yet.
+     */
+    void setSenderThreads(bool enabled, size_t maxQueueDepth, DataTransmitter::OverflowPolicy policy);
+
+    /**
+     * @brief Applies socket options to the transmitter of a zmq-address, creating it if needed.
+     * @param zmqAddress The zmq-address whose socket is configured.
+     * @param options The socket options to apply.
+     * @return True if the options were applied, false otherwise.
+     */
+    bool setSocketOptions(const std::string& zmqAddress, const SocketOptions& options);
+
+    /**
+     * @brief Gets the ZeroMQ context shared by all transmitters.
+     * @return Reference to the shared context.
+     */
+    zmq::context_t& getContext();
+
+    /**
+     * @brief Binds every transmitter that is not bound yet and reads its pending subscriptions.
+     * @return True if the subscriptions of any transmitter changed, false otherwise.
+     */
+    bool pollSubscriptions();
+
     /**
      * @brief Static method to get the singleton instance of DataTransmitterManager.
      * @param verbose Verbosity level for logging (default is 0).
@@ -68,6 +107,10 @@ public:
 
 private:
     int verbose; ///< Verbosity level for logging.
+    zmq::context_t context; ///< ZeroMQ context shared by all transmitters (declared first so it is destroyed last).
+    bool senderThreadsEnabled; ///< Flag indicating new transmitters get a sender thread.
+    size_t sendQueueDepth; ///< Most messages waiting in the queue of each transmitter.
+    DataTransmitter::OverflowPolicy sendQueueOverflowPolicy; ///< What publishing does when a queue is full.
     std::map<std::string, std::shared_ptr<DataTransmitter>> transmitterMap; ///< Map of zmq-addresses to DataTransmitters.
 };
 
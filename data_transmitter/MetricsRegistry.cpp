@@ -0,0 +1,147 @@
+#include "MetricsRegistry.h"
+#include "DataTransmitter.h"
+#include <sstream>
+#include <vector>
+
+/**
+ * @brief Describes one per-channel metric family.
+ */
+struct ChannelMetricFamily {
+    const char* name; ///< Metric name.
+    const char* type; ///< Prometheus metric type.
+    const char* help; ///< Help text.
+    std::atomic<uint64_t> ChannelMetrics::*counter; ///< The counter holding the value.
+    double scale; ///< Factor applied to the counter value.
+};
+
+static const std::vector<ChannelMetricFamily> CHANNEL_FAMILIES = {
+    {"publisher_channel_publishes_total", "counter", "Messages handed to the transmitter.", &ChannelMetrics::publishes, 1.0},
+    {"publisher_channel_published_bytes_total", "counter", "Payload bytes handed to the transmitter, after compression.", &ChannelMetrics::publishedBytes, 1.0},
+    {"publisher_channel_uncompressed_bytes_total", "counter", "Payload bytes before compression.", &ChannelMetrics::uncompressedBytes, 1.0},
+    {"publisher_channel_drops_total", "counter", "Messages dropped because the send queue was full.", &ChannelMetrics::drops, 1.0},
+    {"publisher_channel_failures_total", "counter", "Publishes that failed.", &ChannelMetrics::failures, 1.0},
+    {"publisher_channel_breaks_total", "counter", "Breaks started after a batch of publishes.", &ChannelMetrics::breaks, 1.0},
+    {"publisher_channel_ignored_publishes_total", "counter", "Publishes ignored during breaks.", &ChannelMetrics::ignoredPublishes, 1.0},
+    {"publisher_channel_processor_runs_total", "counter", "Processor runs.", &ChannelMetrics::processorRuns, 1.0},
+    {"publisher_channel_processor_run_seconds_total", "counter", "Time spent in processor runs.", &ChannelMetrics::processorRunNs, 1e-9},
+    {"publisher_channel_buffered_entries", "gauge", "Entries currently in the data buffer.", &ChannelMetrics::bufferedEntries, 1.0},
+};
+
+MetricsRegistry::MetricsRegistry() : startTime(std::chrono::steady_clock::now()) {
+}
+
+MetricsRegistry& MetricsRegistry::Instance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+std::shared_ptr<ChannelMetrics> MetricsRegistry::getChannelMetrics(const std::string& channelId, const std::string& topic, const std::string& address) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<ChannelMetrics>& metrics = channels[channelId];
+    if (!metrics || metrics->topic != topic || metrics->address != address) {
+        // Labels are read without the lock while rendering, so changed labels get new counters
+        metrics = std::make_shared<ChannelMetrics>();
+        metrics->channelId = channelId;
+        metrics->topic = topic;
+        metrics->address = address;
+    }
+    return metrics;
+}
+
+void MetricsRegistry::removeChannel(const std::string& channelId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    channels.erase(channelId);
+}
+
+void MetricsRegistry::registerTransmitter(const std::string& address, std::weak_ptr<DataTransmitter> transmitter) {
+    std::lock_guard<std::mutex> lock(mutex);
+    transmitters[address] = transmitter;
+}
+
+std::string MetricsRegistry::escapeLabel(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string MetricsRegistry::renderPrometheus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+
+    out << "# HELP publisher_uptime_seconds Time since the publisher started.\n"
+        << "# TYPE publisher_uptime_seconds gauge\n"
+        << "publisher_uptime_seconds " << std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() << "\n";
+
+    for (const ChannelMetricFamily& family : CHANNEL_FAMILIES) {
+        out << "# HELP " << family.name << " " << family.help << "\n"
+            << "# TYPE " << family.name << " " << family.type << "\n";
+        for (const auto& channelPair : channels) {
+            const ChannelMetrics& metrics = *channelPair.second;
+            uint64_t value = (metrics.*family.counter).load(std::memory_order_relaxed);
+            out << family.name << "{channel=\"" << escapeLabel(metrics.channelId) << "\",topic=\"" << escapeLabel(metrics.topic)
+                << "\",address=\"" << escapeLabel(metrics.address) << "\"} ";
+            if (family.scale == 1.0) {
+                out << value << "\n";
+            } else {
+                out << value * family.scale << "\n";
+            }
+        }
+    }
+
+    // Stage latencies as summaries, the histograms have too many buckets to export them all
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    out << "# HELP publisher_channel_stage_seconds Latency of each stage of a data channel publish.\n"
+        << "# TYPE publisher_channel_stage_seconds summary\n";
+    for (const auto& channelPair : channels) {
+        const ChannelMetrics& metrics = *channelPair.second;
+        for (size_t i = 0; i < static_cast<size_t>(PublishStage::Count); ++i) {
+            HistogramSnapshot snapshot = metrics.stageLatencies[i].TakeSnapshot();
+            std::string labels = "channel=\"" + escapeLabel(metrics.channelId) + "\",topic=\"" + escapeLabel(metrics.topic) +
+                                 "\",address=\"" + escapeLabel(metrics.address) + "\",stage=\"" +
+                                 ChannelMetrics::GetStageName(static_cast<PublishStage>(i)) + "\"";
+            for (double quantile : quantiles) {
+                out << "publisher_channel_stage_seconds{" << labels << ",quantile=\"" << quantile << "\"} "
+                    << snapshot.GetPercentile(quantile * 100.0) * 1e-9 << "\n";
+            }
+            out << "publisher_channel_stage_seconds_sum{" << labels << "} " << snapshot.sumNs * 1e-9 << "\n"
+                << "publisher_channel_stage_seconds_count{" << labels << "} " << snapshot.count << "\n";
+        }
+    }
+
+    // Send queues only exist with sender threads, the counters stay at zero otherwise
+    std::vector<std::pair<std::string, SendQueueStats>> queues;
+    for (const auto& transmitterPair : transmitters) {
+        if (std::shared_ptr<DataTransmitter> transmitter = transmitterPair.second.lock()) {
+            queues.emplace_back(transmitterPair.first, transmitter->getSendQueueStats());
+        }
+    }
+    auto writeQueueFamily = [&](const char* name, const char* type, const char* help, uint64_t SendQueueStats::*field) {
+        out << "# HELP " << name << " " << help << "\n"
+            << "# TYPE " << name << " " << type << "\n";
+        for (const auto& queue : queues) {
+            out << name << "{address=\"" << escapeLabel(queue.first) << "\"} " << queue.second.*field << "\n";
+        }
+    };
+    out << "# HELP publisher_send_queue_depth Messages waiting in the send queue.\n"
+        << "# TYPE publisher_send_queue_depth gauge\n";
+    for (const auto& queue : queues) {
+        out << "publisher_send_queue_depth{address=\"" << escapeLabel(queue.first) << "\"} " << queue.second.depth << "\n";
+    }
+    writeQueueFamily("publisher_send_queue_queued_total", "counter", "Messages added to the send queue.", &SendQueueStats::queued);
+    writeQueueFamily("publisher_send_queue_sent_total", "counter", "Messages sent by the sender thread.", &SendQueueStats::sent);
+    writeQueueFamily("publisher_send_queue_dropped_total", "counter", "Messages dropped because the queue was full.", &SendQueueStats::dropped);
+    writeQueueFamily("publisher_send_queue_send_failures_total", "counter", "Messages the sender thread failed to send.", &SendQueueStats::sendFailures);
+    writeQueueFamily("publisher_send_queue_backpressure_waits_total", "counter", "Times a publisher had to wait for room in the queue.", &SendQueueStats::backpressureWaits);
+
+    return out.str();
+}
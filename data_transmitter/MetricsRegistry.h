@@ -0,0 +1,136 @@
+// MetricsRegistry.h
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <array>
+#include "LatencyHistogram.h"
+
+class DataTransmitter;
+
+/**
+ * @brief Stages of a data channel publish whose latency is recorded.
+ */
+enum class PublishStage : size_t {
+    Process,   ///< Running the processors, including command execution.
+    Serialize, ///< Serializing the data buffer into the payload.
+    Compress,  ///< Compressing the payload and building the header frame.
+    Send,      ///< Handing the message to the socket, or to the send queue with sender threads.
+    Count      ///< Number of stages.
+};
+
+/**
+ * @brief Counters of one data channel, updated on the publishing path.
+ *
+ * All counters are relaxed atomics, so updating them costs no lock and reading them from the
+ * metrics thread never blocks publishing. The labels are fixed when the channel is added.
+ */
+struct ChannelMetrics {
+    std::string channelId; ///< ID of the channel in the config.
+    std::string topic;     ///< Name the channel publishes under.
+    std::string address;   ///< Address the channel publishes to.
+
+    std::atomic<uint64_t> publishes{0};        ///< Messages handed to the transmitter.
+    std::atomic<uint64_t> publishedBytes{0};   ///< Payload bytes handed to the transmitter, after compression.
+    std::atomic<uint64_t> uncompressedBytes{0}; ///< Payload bytes before compression.
+    std::atomic<uint64_t> drops{0};            ///< Messages dropped because the send queue was full.
+    std::atomic<uint64_t> failures{0};         ///< Publishes that failed.
+    std::atomic<uint64_t> breaks{0};           ///< Breaks started after a batch.
+    std::atomic<uint64_t> ignoredPublishes{0}; ///< Publishes ignored during breaks.
+    std::atomic<uint64_t> processorRuns{0};    ///< Processor runs.
+    std::atomic<uint64_t> processorRunNs{0};   ///< Time spent in processor runs, in ns.
+    std::atomic<uint64_t> bufferedEntries{0};  ///< Entries currently in the data buffer.
+    std::array<LatencyHistogram, static_cast<size_t>(PublishStage::Count)> stageLatencies; ///< Latency of each publish stage.
+
+    /**
+     * @brief Gets the name of a publish stage for metrics and logs.
+     * @param stage The stage.
+     * @return The lower case name.
+     */
+    static const char* GetStageName(PublishStage stage) {
+        static const char* const names[] = {"process", "serialize", "compress", "send"};
+        return names[static_cast<size_t>(stage)];
+    }
+
+    /**
+     * @brief Adds to a counter without ordering constraints.
+     * @param counter The counter.
+     * @param amount Amount to add (default is 1).
+     */
+    static void add(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Collects the metrics of all data channels and transmitters for the metrics endpoint.
+ *
+ * The `MetricsRegistry` class is a singleton that hands out the counters of each data channel
+ * and renders them, together with the send queue statistics of every transmitter, in the
+ * Prometheus text exposition format.
+ * @details The mutex only guards adding and removing entries and rendering, the counters
+ * themselves are updated without it.
+ * @see MetricsServer
+ */
+class MetricsRegistry {
+public:
+    /**
+     * @brief Gets the singleton instance of MetricsRegistry.
+     * @return Reference to the singleton instance.
+     */
+    static MetricsRegistry& Instance();
+
+    /**
+     * @brief Gets the counters of a data channel, creating them if needed.
+     * @param channelId ID of the channel in the config.
+     * @param topic Name the channel publishes under.
+     * @param address Address the channel publishes to.
+     * @return The counters, the same object for the same ID and labels as long as it is not removed.
+     */
+    std::shared_ptr<ChannelMetrics> getChannelMetrics(const std::string& channelId, const std::string& topic, const std::string& address);
+
+    /**
+     * @brief Stops reporting a data channel.
+     * @param channelId ID of the channel in the config.
+     */
+    void removeChannel(const std::string& channelId);
+
+    /**
+     * @brief Reports the send queue statistics of a transmitter.
+     * @param address Address of the transmitter.
+     * @param transmitter The transmitter, not kept alive by the registry.
+     */
+    void registerTransmitter(const std::string& address, std::weak_ptr<DataTransmitter> transmitter);
+
+    /**
+     * @brief Renders all metrics.
+     * @return The metrics in the Prometheus text exposition format, version 0.0.4.
+     */
+    std::string renderPrometheus() const;
+
+private:
+    /**
+     * @brief Private constructor for MetricsRegistry.
+     */
+    MetricsRegistry();
+
+    /**
+     * @brief Escapes a label value for the exposition format.
+     * @param value The label value.
+     * @return The value with backslashes, quotes and newlines escaped.
+     */
+    static std::string escapeLabel(const std::string& value);
+
+    mutable std::mutex mutex; ///< Guards the maps, not the counters.
+    std::map<std::string, std::shared_ptr<ChannelMetrics>> channels; ///< Counters per channel ID.
+    std::map<std::string, std::weak_ptr<DataTransmitter>> transmitters; ///< Transmitters per address.
+    std::chrono::steady_clock::time_point startTime; ///< Time the registry was created.
+};
+
+#endif // METRICSREGISTRY_H
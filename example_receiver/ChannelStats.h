@@ -0,0 +1,147 @@
+// ChannelStats.h
+#ifndef CHANNELSTATS_H
+#define CHANNELSTATS_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include "MessageHeader.h"
+
+/**
+ * @brief Latency percentiles of a set of samples.
+ */
+struct LatencyPercentiles {
+    size_t count = 0; ///< Number of samples.
+    double p50 = 0.0; ///< Median in microseconds.
+    double p90 = 0.0; ///< 90th percentile in microseconds.
+    double p99 = 0.0; ///< 99th percentile in microseconds.
+    double max = 0.0; ///< Maximum in microseconds.
+};
+
+/**
+ * @brief Counters of the messages received on one channel.
+ *
+ * The `ChannelStats` class counts messages, bytes and lost messages of a channel, both since the
+ * last report and since the start, and keeps delivery latency samples for percentiles.
+ * @details Lost messages and latencies need the channel's \ref MessageHeader frame, which
+ * publishers send for channels with "header-frame" enabled. Latencies are measured from the
+ * publisher's send time to the receive time on the wall clock, so both hosts need synchronized
+ * clocks. Samples since the start are kept in a fixed size reservoir, so long runs use
+ * constant memory.
+ */
+class ChannelStats {
+public:
+    static const size_t RESERVOIR_SIZE = 100000; ///< Latency samples kept for the whole run.
+
+    /**
+     * @brief Records a received message.
+     * @param bytes Size of all frames of the message.
+     * @param header The decoded header, a zero sequence number if the message had none.
+     * @param receivedWallNs Wall clock time the message was received, in ns since the Unix epoch.
+     */
+    void record(size_t bytes, const MessageHeader& header, uint64_t receivedWallNs) {
+        intervalMessages++;
+        intervalBytes += bytes;
+        totalMessages++;
+        totalBytes += bytes;
+
+        if (header.sequence == 0) {
+            return;
+        }
+        if (lastSequence != 0 && header.sequence > lastSequence + 1) {
+            uint64_t lost = header.sequence - lastSequence - 1;
+            intervalLost += lost;
+            totalLost += lost;
+        } else if (header.sequence <= lastSequence) {
+            restarts++; // The publisher restarted and counts from 1 again
+        }
+        lastSequence = header.sequence;
+
+        if (header.sentWallNs != 0) {
+            double latencyUs = (static_cast<double>(receivedWallNs) - static_cast<double>(header.sentWallNs)) / 1000.0;
+            intervalLatencies.push_back(latencyUs);
+            addToReservoir(latencyUs);
+        }
+    }
+
+    /**
+     * @brief Computes the latency percentiles since the last report.
+     * @return The percentiles.
+     */
+    LatencyPercentiles getIntervalLatencies() {
+        return computePercentiles(intervalLatencies);
+    }
+
+    /**
+     * @brief Computes the latency percentiles since the start.
+     * @return The percentiles, estimated from the reservoir for long runs.
+     */
+    LatencyPercentiles getTotalLatencies() {
+        std::vector<double> samples = reservoir;
+        return computePercentiles(samples);
+    }
+
+    /**
+     * @brief Starts a new report interval.
+     */
+    void resetInterval() {
+        intervalMessages = 0;
+        intervalBytes = 0;
+        intervalLost = 0;
+        intervalLatencies.clear();
+    }
+
+    uint64_t intervalMessages = 0; ///< Messages since the last report.
+    uint64_t intervalBytes = 0;    ///< Bytes since the last report.
+    uint64_t intervalLost = 0;     ///< Messages lost since the last report.
+    uint64_t totalMessages = 0;    ///< Messages since the start.
+    uint64_t totalBytes = 0;       ///< Bytes since the start.
+    uint64_t totalLost = 0;        ///< Messages lost since the start.
+    uint64_t restarts = 0;         ///< Times the sequence number went back, usually a publisher restart.
+
+private:
+    uint64_t lastSequence = 0; ///< Sequence number of the last message with a header.
+    uint64_t latencySamples = 0; ///< Latency samples seen since the start.
+    std::vector<double> intervalLatencies; ///< Latencies since the last report in microseconds.
+    std::vector<double> reservoir; ///< Uniform sample of the latencies since the start.
+    std::mt19937_64 random{42}; ///< Picks reservoir slots to replace.
+
+    /**
+     * @brief Adds a latency sample to the reservoir, replacing a random one when full.
+     * @param latencyUs The latency in microseconds.
+     */
+    void addToReservoir(double latencyUs) {
+        latencySamples++;
+        if (reservoir.size() < RESERVOIR_SIZE) {
+            reservoir.push_back(latencyUs);
+            return;
+        }
+        uint64_t slot = std::uniform_int_distribution<uint64_t>(0, latencySamples - 1)(random);
+        if (slot < RESERVOIR_SIZE) {
+            reservoir[slot] = latencyUs;
+        }
+    }
+
+    /**
+     * @brief Computes percentiles of latency samples.
+     * @param samples Samples in microseconds (reordered in place).
+     * @return The percentiles.
+     */
+    static LatencyPercentiles computePercentiles(std::vector<double>& samples) {
+        LatencyPercentiles percentiles;
+        if (samples.empty()) {
+            return percentiles;
+        }
+        std::sort(samples.begin(), samples.end());
+        percentiles.count = samples.size();
+        percentiles.p50 = samples[samples.size() / 2];
+        percentiles.p90 = samples[samples.size() * 90 / 100];
+        percentiles.p99 = samples[samples.size() * 99 / 100];
+        percentiles.max = samples.back();
+        return percentiles;
+    }
+};
+
+#endif // CHANNELSTATS_H
@@ -1,39 +1,383 @@
+/**
+ * @file ExampleReceiver.cpp
+ * @brief Receives the messages of every channel in the publisher's config and reports
+ * per-channel message rate, byte rate, lost messages and delivery latency percentiles.
+ *
+ * One SUB socket is connected per address of the enabled data channels, subscribed to the
+ * channel names. Every report interval a table of the interval's statistics is printed, and a
+ * summary of the whole run when the receiver stops. Lost messages and latencies need the
+ * channels' header frames ("header-frame": true).
+ *
+ * Usage: example_receiver [--config path] [--address zmq-address] [--quiet]
+ *                         [--interval-ms N] [--duration-s N]
+ *   --config       Publisher config to read the channels from (default: the repository's config.json).
+ *   --address      Subscribe to everything at this address instead of reading the config.
+ *   --quiet        Do not print every message, only the reports. Payloads are not decoded.
+ *   --interval-ms  Time between reports (default 1000).
+ *   --duration-s   Stop after this many seconds (default 0, run until interrupted).
+ */
+
 #include <zmq.hpp>
 #include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <nlohmann/json.hpp>
 #include <ProjectPrinter.h>
+#include <MessageHeader.h>
+#include <PayloadCompressor.h>
+#include <JsonManager.h>
+#include <SignalHandler.h>
+#include "ChannelStats.h"
 
-int main() {
-    ProjectPrinter printer;
+const int DEFAULT_REPORT_INTERVAL_MS = 1000;
+const std::string DEFAULT_ZMQ_ADDRESS = "tcp://127.0.0.1:5555";
 
-    zmq::context_t context(1);
-    zmq::socket_t subscriberSocket(context, ZMQ_SUB);
+/**
+ * @brief Command line options of the receiver.
+ */
+struct ReceiverOptions {
+    std::string configPath;  ///< Publisher config, empty for the default one.
+    std::string address;     ///< Address to subscribe to everything at, empty to read the config.
+    bool quiet = false;      ///< Flag indicating messages are not printed.
+    int intervalMs = DEFAULT_REPORT_INTERVAL_MS; ///< Time between reports.
+    int durationS = 0;       ///< Run time, 0 to run until interrupted.
+};
 
-    // Connect to the specified address
-    const std::string zmqAddress = "tcp://127.0.0.1:5555";
-    subscriberSocket.connect(zmqAddress);
+/**
+ * @brief A publisher address the receiver is connected to.
+ */
+struct Endpoint {
+    std::string address;             ///< The publisher's address.
+    std::vector<std::string> topics; ///< Channel names subscribed to, an empty name subscribes to everything.
+    std::unique_ptr<zmq::socket_t> socket; ///< SUB socket connected to the address.
+    std::unordered_map<std::string, ChannelStats> stats; ///< Statistics per topic.
 
-    // Subscribe to all messages
-    subscriberSocket.set(zmq::sockopt::subscribe, "");
+    /**
+     * @brief Checks if every message at the address starts with a topic frame.
+     * @return True if no channel at the address has an empty name, false otherwise.
+     */
+    bool alwaysHasTopic() const {
+        return std::find(topics.begin(), topics.end(), "") == topics.end();
+    }
+};
 
-    printer.Print("Connected to address " + zmqAddress + " and subscribed to all messages.");
+/**
+ * @brief Parses the command line.
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return The options.
+ * @throws std::runtime_error for unknown or incomplete arguments.
+ */
+ReceiverOptions parseArguments(int argc, char* argv[]) {
+    ReceiverOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--quiet") {
+            options.quiet = true;
+        } else if (argument == "--config" && hasValue) {
+            options.configPath = argv[++i];
+        } else if (argument == "--address" && hasValue) {
+            options.address = argv[++i];
+        } else if (argument == "--interval-ms" && hasValue) {
+            options.intervalMs = std::max(1, std::stoi(argv[++i]));
+        } else if (argument == "--duration-s" && hasValue) {
+            options.durationS = std::stoi(argv[++i]);
+        } else {
+            throw std::runtime_error("Unknown or incomplete argument: " + argument);
+        }
+    }
+    return options;
+}
 
-    while (true) {
-        zmq::message_t message;
+/**
+ * @brief Turns an address the publisher binds to into one the receiver can connect to.
+ * @param address The bind address, for example tcp://0.0.0.0:5555.
+ * @return The address with wildcard hosts replaced by the loopback address.
+ */
+std::string toConnectAddress(const std::string& address) {
+    for (const std::string wildcard : {"://*:", "://0.0.0.0:"}) {
+        size_t position = address.find(wildcard);
+        if (position != std::string::npos) {
+            return address.substr(0, position) + "://127.0.0.1:" + address.substr(position + wildcard.size());
+        }
+    }
+    return address;
+}
 
-        // Receive the message
-        if (!subscriberSocket.recv(message, zmq::recv_flags::none)) {
-            printer.PrintError("Failed to receive a message");
-            // Handle the case where recv did not succeed
+/**
+ * @brief Collects the addresses and channel names of the enabled data channels.
+ * @param config The publisher config.
+ * @return One endpoint per address, not connected yet.
+ */
+std::vector<Endpoint> endpointsFromConfig(const nlohmann::json& config) {
+    std::vector<Endpoint> endpoints;
+    if (!config.contains("data-channels")) {
+        return endpoints;
+    }
+    for (const auto& channel : config["data-channels"].items()) {
+        const nlohmann::json& channelConfig = channel.value();
+        if (!channelConfig.value("enabled", true)) {
             continue;
         }
+        std::string address = channelConfig.value("zmq-address", DEFAULT_ZMQ_ADDRESS);
+        auto endpoint = std::find_if(endpoints.begin(), endpoints.end(), [&](const Endpoint& e) { return e.address == address; });
+        if (endpoint == endpoints.end()) {
+            endpoints.emplace_back();
+            endpoint = endpoints.end() - 1;
+            endpoint->address = address;
+        }
+        endpoint->topics.push_back(channelConfig.value("name", ""));
+    }
+    return endpoints;
+}
 
-        printer.Print("Received a message of size " + std::to_string(message.size()) + " bytes");
+/**
+ * @brief Receives all frames of the next message without waiting for one.
+ * @param socket The socket to receive from.
+ * @param frames Reused frames, receives the message.
+ * @return Number of frames received, 0 if no message was waiting.
+ */
+size_t receiveMessage(zmq::socket_t& socket, std::vector<zmq::message_t>& frames) {
+    size_t count = 0;
+    do {
+        if (count == frames.size()) {
+            frames.emplace_back();
+        } else {
+            frames[count].rebuild();
+        }
+        // The frames of a message arrive together, only the first one can be missing
+        if (!socket.recv(frames[count], count == 0 ? zmq::recv_flags::dontwait : zmq::recv_flags::none)) {
+            return 0;
+        }
+        count++;
+    } while (frames[count - 1].more());
+    return count;
+}
+
+/**
+ * @brief Decodes a payload to JSON text for printing.
+ * @param payload The decompressed payload.
+ * @param format The serialization format from the message header.
+ * @return The payload as JSON text.
+ */
+std::string decodePayload(const std::string& payload, SerializationFormat format) {
+    switch (format) {
+        case SerializationFormat::MessagePack:
+            return nlohmann::json::from_msgpack(payload).dump();
+        case SerializationFormat::Cbor:
+            return nlohmann::json::from_cbor(payload).dump();
+        default:
+            return payload;
+    }
+}
 
-        // Convert the received message to a string
-        std::string data(static_cast<char*>(message.data()), message.size());
+/**
+ * @brief Prints a received message.
+ * @param topic The topic of the message.
+ * @param header The decoded header.
+ * @param payload The payload frame.
+ */
+void printMessage(const std::string& topic, const MessageHeader& header, const zmq::message_t& payload) {
+    ProjectPrinter printer;
+    printer.Print("Received a message of size " + std::to_string(payload.size()) + " bytes on topic '" + topic +
+                  "' (" + MessageHeader::GetFormatName(header.format) + ", compression " +
+                  PayloadCompressor::GetCodecName(header.compression) + ", sequence " + std::to_string(header.sequence) + ")");
 
-        // Print the received message
-        printer.Print("Message content: " + data);
+    std::string data;
+    if (!PayloadCompressor::Decompress(header.compression, payload.data(), payload.size(), header.uncompressedSize, data)) {
+        printer.PrintError("Failed to decompress the message, " + PayloadCompressor::GetCodecName(header.compression) +
+                           " is not available or the data is corrupt");
+        return;
+    }
+    try {
+        printer.Print("Message content: " + decodePayload(data, header.format));
+    } catch (const nlohmann::json::exception& e) {
+        printer.PrintError("Failed to decode the message: " + std::string(e.what()));
+    }
+}
+
+/**
+ * @brief Handles a received message: splits its frames, records it and prints it.
+ * @param endpoint The endpoint the message was received on.
+ * @param frames The frames of the message.
+ * @param count Number of frames.
+ * @param quiet Flag indicating the message is not printed.
+ */
+void handleMessage(Endpoint& endpoint, const std::vector<zmq::message_t>& frames, size_t count, bool quiet) {
+    uint64_t receivedWallNs = MessageHeader::WallNowNs();
+
+    // A message is [topic] [header] payload, the topic and header frames are optional
+    size_t next = 0;
+    std::string topic;
+    if (count >= 3 || (count == 2 && (endpoint.alwaysHasTopic() || !MessageHeader::IsHeaderFrame(frames[0].data(), frames[0].size())))) {
+        topic.assign(static_cast<const char*>(frames[0].data()), frames[0].size());
+        next = 1;
+    }
+    MessageHeader header;
+    if (count - next >= 2) {
+        try {
+            header = MessageHeader::Decode(frames[next].data(), frames[next].size());
+        } catch (const std::runtime_error& e) {
+            ProjectPrinter().PrintWarning("Invalid header frame on topic '" + topic + "': " + e.what());
+        }
+    }
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bytes += frames[i].size();
+    }
+    endpoint.stats[topic].record(bytes, header, receivedWallNs);
+
+    if (!quiet) {
+        printMessage(topic, header, frames[count - 1]);
+    }
+}
+
+/**
+ * @brief Prints the header of the report table.
+ * @param title Title of the table.
+ */
+void printReportHeader(const std::string& title) {
+    std::printf("%s\n%-44s %10s %10s %8s %10s %10s %10s %10s\n", title.c_str(), "channel", "msg/s", "MB/s", "lost",
+                "p50_us", "p90_us", "p99_us", "max_us");
+}
+
+/**
+ * @brief Prints one row of the report table.
+ * @param name Address and topic of the channel.
+ * @param messages Messages received.
+ * @param bytes Bytes received.
+ * @param lost Messages lost.
+ * @param latencies Delivery latency percentiles.
+ * @param seconds Time the counts were collected over.
+ */
+void printReportRow(const std::string& name, uint64_t messages, uint64_t bytes, uint64_t lost,
+                    const LatencyPercentiles& latencies, double seconds) {
+    std::printf("%-44s %10.1f %10.3f %8llu %10.1f %10.1f %10.1f %10.1f\n", name.c_str(), messages / seconds,
+                bytes / seconds / 1e6, static_cast<unsigned long long>(lost), latencies.p50, latencies.p90,
+                latencies.p99, latencies.max);
+}
+
+/**
+ * @brief Gets the name of a channel in the report.
+ * @param endpoint The endpoint of the channel.
+ * @param topic The channel's topic.
+ * @return The address and topic.
+ */
+std::string channelName(const Endpoint& endpoint, const std::string& topic) {
+    return endpoint.address + " " + (topic.empty() ? "<no topic>" : topic);
+}
+
+int main(int argc, char* argv[]) {
+    ProjectPrinter printer;
+    ReceiverOptions options;
+    std::vector<Endpoint> endpoints;
+    try {
+        options = parseArguments(argc, argv);
+        if (!options.address.empty()) {
+            endpoints.emplace_back();
+            endpoints.back().address = options.address;
+            endpoints.back().topics.push_back("");
+        } else {
+            const nlohmann::json& config = options.configPath.empty() ? JsonManager::getInstance().getConfig()
+                                                                      : JsonManager::getInstance(options.configPath).getConfig();
+            endpoints = endpointsFromConfig(config);
+        }
+    } catch (const std::exception& e) {
+        printer.PrintError(e.what());
+        return 1;
+    }
+    if (endpoints.empty()) {
+        printer.PrintError("No enabled data channels to subscribe to");
+        return 1;
+    }
+
+    // Stop cleanly on Ctrl+C so the summary is printed
+    SignalHandler& signalHandler = SignalHandler::getInstance();
+
+    zmq::context_t context(1);
+    std::vector<zmq::pollitem_t> pollItems;
+    for (Endpoint& endpoint : endpoints) {
+        endpoint.socket.reset(new zmq::socket_t(context, ZMQ_SUB));
+        endpoint.socket->connect(toConnectAddress(endpoint.address));
+        bool subscribedToAll = !endpoint.alwaysHasTopic();
+        if (subscribedToAll) {
+            endpoint.socket->set(zmq::sockopt::subscribe, "");
+        } else {
+            for (const std::string& topic : endpoint.topics) {
+                endpoint.socket->set(zmq::sockopt::subscribe, topic);
+            }
+        }
+        pollItems.push_back({static_cast<void*>(*endpoint.socket), 0, ZMQ_POLLIN, 0});
+        printer.Print("Connected to address " + endpoint.address + " and subscribed to " +
+                      (subscribedToAll ? std::string("all messages.") : std::to_string(endpoint.topics.size()) + " channel(s)."));
+    }
+
+    std::vector<zmq::message_t> frames;
+    auto start = std::chrono::steady_clock::now();
+    auto lastReport = start;
+    auto interval = std::chrono::milliseconds(options.intervalMs);
+    auto end = options.durationS > 0 ? start + std::chrono::seconds(options.durationS) : std::chrono::steady_clock::time_point::max();
+
+    while (!signalHandler.isQuitSignalReceived()) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= end) {
+            break;
+        }
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(std::min(lastReport + interval, end) - now);
+        try {
+            zmq::poll(pollItems.data(), pollItems.size(), std::max(timeout, std::chrono::milliseconds(0)));
+        } catch (const zmq::error_t& e) {
+            if (e.num() != EINTR) {
+                throw;
+            }
+        }
+
+        for (size_t i = 0; i < endpoints.size(); ++i) {
+            if (!(pollItems[i].revents & ZMQ_POLLIN)) {
+                continue;
+            }
+            size_t count;
+            while ((count = receiveMessage(*endpoints[i].socket, frames)) > 0) {
+                handleMessage(endpoints[i], frames, count, options.quiet);
+            }
+        }
+
+        now = std::chrono::steady_clock::now();
+        if (now >= lastReport + interval) {
+            double seconds = std::chrono::duration<double>(now - lastReport).count();
+            double elapsed = std::chrono::duration<double>(now - start).count();
+            printReportHeader("[" + std::to_string(static_cast<int>(elapsed)) + " s]");
+            for (Endpoint& endpoint : endpoints) {
+                for (auto& channel : endpoint.stats) {
+                    ChannelStats& stats = channel.second;
+                    printReportRow(channelName(endpoint, channel.first), stats.intervalMessages, stats.intervalBytes,
+                                   stats.intervalLost, stats.getIntervalLatencies(), seconds);
+                    stats.resetInterval();
+                }
+            }
+            std::fflush(stdout);
+            lastReport = now;
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printReportHeader("Summary over " + std::to_string(elapsed) + " s");
+    for (Endpoint& endpoint : endpoints) {
+        for (auto& channel : endpoint.stats) {
+            ChannelStats& stats = channel.second;
+            printReportRow(channelName(endpoint, channel.first), stats.totalMessages, stats.totalBytes, stats.totalLost,
+                           stats.getTotalLatencies(), elapsed);
+            if (stats.restarts > 0) {
+                std::printf("  sequence restarted %llu time(s), lost counts may be incomplete\n",
+                            static_cast<unsigned long long>(stats.restarts));
+            }
+        }
     }
 
     return 0;
@@ -5,11 +5,18 @@
 
 // Project Headers needed to run Main
 #include "ProjectPrinter.h"
+#include "Logging.h"
 #include "JsonManager.h"
 #include "DataTransmitterManager.h"
 #include "DataChannelManager.h"
 #include "SignalHandler.h"
 #include "GeneralProcessorFactory.h"
+#include "CommandExecutor.h"
+#include "AsyncLogger.h"
+#include "MetricsRegistry.h"
+#include "MetricsServer.h"
+#include "TraceRecorder.h"
+#include "ControlSocket.h"
 
 // Project Headers for processors
 #include "GeneralProcessor.h"
@@ -20,9 +27,42 @@
 #include <fstream>
 #include <chrono>
 #include <thread>
+#include <algorithm>
 
 using json = nlohmann::json;
 
+// Longest time the main loop sleeps before checking for a quit signal
+const int MAX_SLEEP_MS = 100;
+
+// Number of ZeroMQ I/O threads shared by all addresses
+const int DEFAULT_IO_THREADS = 1;
+
+// Sending happens on the main loop unless sender threads are enabled
+const bool DEFAULT_SENDER_THREADS = false;
+const int DEFAULT_SEND_QUEUE_DEPTH = 1000;
+const std::string DEFAULT_SEND_QUEUE_OVERFLOW = "drop";
+
+// Channels are published on the main thread unless more worker threads are configured
+const int DEFAULT_WORKER_THREADS = 1;
+
+// Printing only queues lines for a background writer, so publishing threads never wait for the terminal
+const bool DEFAULT_ASYNC_LOGGING = true;
+const int DEFAULT_LOG_BUFFER_LINES = 8192;
+
+// The metrics endpoint is off unless a port is configured, and only reachable locally by default
+const int DEFAULT_METRICS_PORT = 0;
+const std::string DEFAULT_METRICS_BIND_ADDRESS = "127.0.0.1";
+
+// Publish stage latencies are only printed when an interval is configured
+const int DEFAULT_LATENCY_LOG_INTERVAL_MS = 0;
+
+// Runtime control is off unless an address is configured, e.g. ipc:///tmp/publisher-control
+const std::string DEFAULT_CONTROL_ADDRESS = "";
+
+// Spans kept by --trace, the oldest are overwritten
+const std::string DEFAULT_TRACE_PATH = "publisher_trace.json";
+const int DEFAULT_TRACE_BUFFER_SPANS = 100000;
+
 /**
  * @brief Function to register processor classes.
  *
@@ -43,9 +83,52 @@ void registerProcessors(nlohmann::json config) {
     factory.RegisterProcessor("CommandProcessor", [verbose]() -> CommandProcessor* { return new CommandProcessor(verbose); });
 }
 
+/**
+ * @brief Builds the file name of a trace dump requested by a signal.
+ * @param path The trace path given with --trace.
+ * @param dumpNumber Number of the dump, so earlier dumps are not overwritten.
+ * @return The path with the number inserted before the extension.
+ */
+std::string numberedTracePath(const std::string& path, int dumpNumber) {
+    size_t extension = path.rfind('.');
+    if (extension == std::string::npos || path.find('/', extension) != std::string::npos) {
+        return path + "-" + std::to_string(dumpNumber);
+    }
+    return path.substr(0, extension) + "-" + std::to_string(dumpNumber) + path.substr(extension);
+}
+
+/**
+ * @brief Reloads config.json and applies the changed data channels.
+ * @param config The running configuration, its data channels are replaced by the reloaded ones.
+ * @param dataChannelManager Manager of the running data channels.
+ * @details The running configuration is kept if the file cannot be loaded. Changed general
+ * settings only take effect after a restart.
+ */
+void reloadConfig(nlohmann::json& config, DataChannelManager& dataChannelManager) {
+    ProjectPrinter printer;
+    JsonManager& jsonManager = JsonManager::getInstance();
+    try {
+        jsonManager.loadConfigFile();
+    } catch (const std::exception& e) {
+        printer.PrintError("Failed to reload the configuration, keeping the running one: " + std::string(e.what()), __LINE__, __FILE__);
+        return;
+    }
+
+    const nlohmann::json& reloadedConfig = jsonManager.getConfig();
+    if (reloadedConfig.value("general-settings", json::object()) != config["general-settings"]) {
+        printer.PrintWarning("Changed general settings take effect after a restart", __LINE__, __FILE__);
+    }
+    config["data-channels"] = reloadedConfig.value("data-channels", json::object());
+    dataChannelManager.reloadChannels(config["data-channels"]);
+}
+
 /**
  * @brief The main function of the program.
  *
+ * Pass --trace or --trace=path to record a timeline of the main loop, the processors,
+ * serialization and socket sends. It is written as Chrome trace JSON on SIGUSR1 and at exit.
+ * SIGHUP reloads config.json and only changes the data channels whose configuration changed.
+ *
  * @param argc Number of command-line arguments.
  * @param argv Array of command-line arguments.
  * @return Exit code.
@@ -54,40 +137,130 @@ int main(int argc, char* argv[]) {
     // Create an instance of ProjectPrinter
     ProjectPrinter printer;
 
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--trace") {
+            tracePath = DEFAULT_TRACE_PATH;
+        } else if (argument.rfind("--trace=", 0) == 0) {
+            tracePath = argument.substr(std::string("--trace=").size());
+        } else {
+            printer.PrintWarning("Ignoring unknown argument " + argument, __LINE__, __FILE__);
+        }
+    }
+
     // Get cleaned up config
     nlohmann::json config = JsonManager::getInstance().getConfig();
     
     // Get verbosity level from configuration
     int verbose = config["general-settings"]["verbose"].get<int>();
 
+    // Move terminal output off the publishing threads
+    if (config["general-settings"].value("async-logging", DEFAULT_ASYNC_LOGGING)) {
+        AsyncLogger::Instance().start(config["general-settings"].value("log-buffer-lines", DEFAULT_LOG_BUFFER_LINES));
+    }
+
     // Initialize the DataTransmitterManager
-    DataTransmitterManager::Instance(config["general-settings"]["verbose"].get<int>());
+    DataTransmitterManager& transmitterManager = DataTransmitterManager::Instance(config["general-settings"]["verbose"].get<int>());
+
+    // Must happen before any channel creates its transmitter
+    transmitterManager.setIoThreads(config["general-settings"].value("io-threads", DEFAULT_IO_THREADS));
+    transmitterManager.setSenderThreads(config["general-settings"].value("sender-threads", DEFAULT_SENDER_THREADS),
+                                        config["general-settings"].value("send-queue-depth", DEFAULT_SEND_QUEUE_DEPTH),
+                                        DataTransmitter::parseOverflowPolicy(config["general-settings"].value("send-queue-overflow", DEFAULT_SEND_QUEUE_OVERFLOW)));
 
     // Register processors so we can map strings to processor objects
     registerProcessors(config);
 
     // Initialize DataChannelManager with configuration and verbosity level
     DataChannelManager dataChannelManager(config["data-channels"], config["general-settings"]["verbose"].get<int>());
+    dataChannelManager.setWorkerThreads(std::max(config["general-settings"].value("worker-threads", DEFAULT_WORKER_THREADS), 1));
+
+    // Serve the channel counters over HTTP so load can be watched without subscribing
+    MetricsServer metricsServer(verbose);
+    int metricsPort = config["general-settings"].value("metrics-port", DEFAULT_METRICS_PORT);
+    if (metricsPort > 0) {
+        metricsServer.start(config["general-settings"].value("metrics-bind-address", DEFAULT_METRICS_BIND_ADDRESS), metricsPort,
+                            []() { return MetricsRegistry::Instance().renderPrometheus(); });
+    }
+
+    // Let operators pause channels and change periods and buffers without a restart
+    ControlSocket controlSocket(transmitterManager.getContext(), verbose);
+    std::string controlAddress = config["general-settings"].value("control-address", DEFAULT_CONTROL_ADDRESS);
+    if (!controlAddress.empty() && controlSocket.bind(controlAddress)) {
+        printer.Print("Accepting control requests on " + controlAddress);
+    }
+
+    // Record the timeline from the first tick on, dumps are requested with SIGUSR1
+    int traceDumps = 0;
+    if (!tracePath.empty()) {
+        TraceRecorder::Instance().enable(config["general-settings"].value("trace-buffer-spans", DEFAULT_TRACE_BUFFER_SPANS));
+        SignalHandler::getInstance().enableTraceDumpSignal();
+        printer.Print("Tracing to " + tracePath + ", send SIGUSR1 to write the timeline so far.");
+    }
 
-    // Set the global tick time
-    dataChannelManager.setGlobalTickTime();
-    int tickTime = dataChannelManager.getGlobalTickTime();
+    // Reload the data channels on SIGHUP instead of quitting
+    SignalHandler::getInstance().enableReloadSignal();
+
+    int latencyLogIntervalMs = config["general-settings"].value("latency-log-interval-ms", DEFAULT_LATENCY_LOG_INTERVAL_MS);
+    auto nextLatencyLog = std::chrono::steady_clock::now() + std::chrono::milliseconds(latencyLogIntervalMs);
 
     // Main loop
     while (!SignalHandler::getInstance().isQuitSignalReceived()) {
-        // Publish data
-        dataChannelManager.publish();
+        auto now = std::chrono::steady_clock::now();
+        {
+            TraceScope tickScope("tick", "loop");
 
-        // Print message if verbose
-        if (verbose > 0) {
-            printer.Print("Finished loop, sleeping for " + std::to_string(tickTime) + "ms ...");
+            // Apply reloads and control requests between ticks, when no channel is publishing
+            if (SignalHandler::getInstance().takeReloadRequest()) {
+                reloadConfig(config, dataChannelManager);
+            }
+            controlSocket.handleRequests([&dataChannelManager](const json& request) {
+                return dataChannelManager.handleControlRequest(request);
+            });
+
+            // Wake up channels that gained subscribers, then publish the channels that are due
+            dataChannelManager.updateSubscriptions();
+            dataChannelManager.publishDue();
+
+            now = std::chrono::steady_clock::now();
+            if (latencyLogIntervalMs > 0 && now >= nextLatencyLog) {
+                dataChannelManager.logStageLatencies();
+                nextLatencyLog = now + std::chrono::milliseconds(latencyLogIntervalMs);
+            }
+        }
+
+        if (SignalHandler::getInstance().takeTraceDumpRequest()) {
+            std::string dumpPath = numberedTracePath(tracePath, ++traceDumps);
+            if (TraceRecorder::Instance().dump(dumpPath)) {
+                printer.Print("Wrote trace to " + dumpPath);
+            } else {
+                printer.PrintError("Failed to write trace to " + dumpPath, __LINE__, __FILE__);
+            }
         }
 
-        // Sleep for the specified tick time
-        std::this_thread::sleep_for(std::chrono::milliseconds(tickTime));
+        // Wait until the next channel is due, but wake up regularly to check for signals
+        auto wakeTime = std::min(dataChannelManager.getNextDeadline(), now + std::chrono::milliseconds(MAX_SLEEP_MS));
+
+        // Print message if verbose
+        LOG_VERBOSE(verbose, 1, "Finished loop, waiting for up to " +
+                                std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(wakeTime - now).count()) + "ms ...");
+
+        // Collect output of asynchronous commands while waiting, finished commands end the wait early
+        TraceScope waitScope("wait", "loop");
+        CommandExecutor::Instance().waitForEvents(wakeTime);
     }
 
     // Print message and exit
     printer.Print("Received quit signal. Exiting the loop and ending program.");
+    metricsServer.stop();
+    if (!tracePath.empty()) {
+        if (TraceRecorder::Instance().dump(tracePath)) {
+            printer.Print("Wrote trace to " + tracePath);
+        } else {
+            printer.PrintError("Failed to write trace to " + tracePath, __LINE__, __FILE__);
+        }
+    }
+    AsyncLogger::Instance().stop();
     return 0;
 }
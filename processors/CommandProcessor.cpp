@@ -1,12 +1,39 @@
 #include "CommandProcessor.h"
-#include "ProjectPrinter.h"
+#include "Logging.h"
 
 CommandProcessor::CommandProcessor(int verbose, const CommandRunner& runner)
-    : GeneralProcessor(verbose), commandRunner(runner) {}
+    : GeneralProcessor(verbose), commandRunner(runner), async(false), persistent(false) {}
 
 std::vector<std::string> CommandProcessor::getProcessedOutput() {
     std::vector<std::string> result;
-    result.push_back(commandRunner.execute());
+    if (persistent) {
+        result = commandStream.takeRecords();
+        commandStream.startIfDue();
+        return result;
+    }
+
+    if (!async) {
+        std::string output = commandRunner.execute();
+        if (commandRunner.lastExecutionTimedOut()) {
+            printTimeoutWarning();
+        } else {
+            result.push_back(output);
+        }
+        return result;
+    }
+
+    if (commandRunner.hasFinishedOutput()) {
+        std::string output = commandRunner.takeOutput();
+        if (commandRunner.lastExecutionTimedOut()) {
+            printTimeoutWarning();
+        } else {
+            result.push_back(output);
+        }
+    }
+
+    if (!commandRunner.isRunning() && commandRunner.isReadyForExecution()) {
+        commandRunner.launch(readyCallback);
+    }
     return result;
 }
 
@@ -19,13 +46,43 @@ const CommandRunner& CommandProcessor::getCommandRunner() const {
 }
 
 bool CommandProcessor::isReadyToProcess() const {
+    if (persistent) {
+        return commandStream.hasRecords() ||
+               (!commandStream.isRunning() && std::chrono::steady_clock::now() >= commandStream.getRestartTime());
+    }
+    if (async) {
+        return commandRunner.hasFinishedOutput() || (!commandRunner.isRunning() && commandRunner.isReadyForExecution());
+    }
     if (commandRunner.isReadyForExecution()) {
         return true;
     }
-    ProjectPrinter printer;
     return false;
 }
 
+void CommandProcessor::skipProcessing() {
+    if (persistent) {
+        commandStream.takeRecords();
+        commandStream.startIfDue();
+        return;
+    }
+    if (async && commandRunner.hasFinishedOutput()) {
+        commandRunner.takeOutput();
+        return;
+    }
+    if (!commandRunner.isRunning()) {
+        commandRunner.skipExecution();
+    }
+}
+
+void CommandProcessor::stop() {
+    if (persistent) {
+        commandStream.stop();
+    } else {
+        commandRunner.detachCallbacks();
+        commandRunner.terminate();
+    }
+}
+
 int CommandProcessor::getPeriod() const {
     return commandRunner.getWaitTime();
 }
@@ -34,6 +91,57 @@ void CommandProcessor::setPeriod(int newPeriod) {
     commandRunner.setWaitTime(newPeriod);
 }
 
+std::chrono::steady_clock::time_point CommandProcessor::getNextProcessTime() const {
+    if (persistent) {
+        if (commandStream.hasRecords()) {
+            return std::chrono::steady_clock::now();
+        }
+        if (commandStream.isRunning()) {
+            // The stream reschedules the channel when records arrive or the command exits
+            return std::chrono::steady_clock::time_point::max();
+        }
+        return commandStream.getRestartTime();
+    }
+    if (async) {
+        if (commandRunner.hasFinishedOutput()) {
+            return std::chrono::steady_clock::now();
+        }
+        if (commandRunner.isRunning()) {
+            // The ready callback reschedules the channel when the command finishes
+            return std::chrono::steady_clock::time_point::max();
+        }
+    }
+    return commandRunner.getNextExecutionTime();
+}
+
+void CommandProcessor::setAsync(bool async) {
+    this->async = async;
+}
+
+bool CommandProcessor::isAsync() const {
+    return async;
+}
+
+void CommandProcessor::setPersistent(bool persistent, CommandStream::Delimiter delimiter, int restartBackoffMs, int maxRestartBackoffMs) {
+    this->persistent = persistent;
+    if (persistent) {
+        commandStream = CommandStream(commandRunner, delimiter, restartBackoffMs, maxRestartBackoffMs);
+        commandStream.setReadyCallback([this]() {
+            if (readyCallback) {
+                readyCallback();
+            }
+        });
+    }
+}
+
+bool CommandProcessor::isPersistent() const {
+    return persistent;
+}
+
+void CommandProcessor::printTimeoutWarning() const {
+    LOG_WARNING("Command timed out after " + std::to_string(commandRunner.getTimeout()) + "ms: " + commandRunner.getCommand());
+}
+
 CommandProcessor::~CommandProcessor() {
     // Destructor
 }
@@ -4,6 +4,7 @@
 
 #include "GeneralProcessor.h"
 #include "CommandRunner.h"
+#include "CommandStream.h"
 #include <string>
 #include <vector>
 
@@ -53,6 +54,19 @@ public:
      */
     bool isReadyToProcess() const override;
 
+    /**
+     * @brief Skips the due command execution, or discards output that already arrived.
+     * @details Persistent streams keep running, their records are dropped. Asynchronous
+     * commands that are running are left to finish and their output is dropped later.
+     */
+    void skipProcessing() override;
+
+    /**
+     * @brief Terminates a running asynchronous launch or persistent co-process.
+     * @details A persistent co-process is not restarted afterwards.
+     */
+    void stop() override;
+
     /**
      * @brief Gets the processing period for the CommandProcessor.
      * @return The processing period.
@@ -65,8 +79,56 @@ public:
      */
     void setPeriod(int newPeriod) override;
 
+    /**
+     * @brief Gets the time at which the command is next due to run.
+     * @return The next execution time of the command runner.
+     */
+    std::chrono::steady_clock::time_point getNextProcessTime() const override;
+
+    /**
+     * @brief Sets whether the command is launched asynchronously.
+     * @param async True to launch the command and collect its output when it finishes,
+     * false to block until the command finishes.
+     * @details In asynchronous mode a slow command no longer delays other channels. Its output
+     * is published on the first call after the command finishes.
+     */
+    void setAsync(bool async);
+
+    /**
+     * @brief Checks if the command is launched asynchronously.
+     * @return True if asynchronous, false otherwise.
+     */
+    bool isAsync() const;
+
+    /**
+     * @brief Sets whether the command runs as a persistent co-process.
+     * @param persistent True to start the command once and publish every record it writes,
+     * false to run the command once per period.
+     * @param delimiter How records are separated in the command's output.
+     * @param restartBackoffMs Delay in milliseconds before restarting the command after it exits.
+     * @param maxRestartBackoffMs Longest delay in milliseconds between restarts.
+     * @details In persistent mode the period is ignored; records are published as they arrive.
+     * @see CommandStream
+     */
+    void setPersistent(bool persistent, CommandStream::Delimiter delimiter = CommandStream::Delimiter::Newline,
+                       int restartBackoffMs = 1000, int maxRestartBackoffMs = 60000);
+
+    /**
+     * @brief Checks if the command runs as a persistent co-process.
+     * @return True if persistent, false otherwise.
+     */
+    bool isPersistent() const;
+
 protected:
     CommandRunner commandRunner; ///< The command runner responsible for executing commands.
+    bool async; ///< Flag indicating the command is launched asynchronously.
+    bool persistent; ///< Flag indicating the command runs as a persistent co-process.
+    CommandStream commandStream; ///< Record stream of the co-process in persistent mode.
+
+    /**
+     * @brief Prints a warning that the command was killed for exceeding its timeout.
+     */
+    void printTimeoutWarning() const;
 };
 
 #endif // COMMAND_PROCESSOR_H
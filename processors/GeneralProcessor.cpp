@@ -2,7 +2,9 @@
 #include "GeneralProcessor.h"
 #include "ProjectPrinter.h"
 
-GeneralProcessor::GeneralProcessor(int verbose) : verbose(verbose) {}
+const int DEFAULT_GENERAL_PROCESSOR_PERIOD = 1000;
+
+GeneralProcessor::GeneralProcessor(int verbose) : verbose(verbose), period(DEFAULT_GENERAL_PROCESSOR_PERIOD) {}
 
 std::vector<std::string> GeneralProcessor::getProcessedOutput() {
     // Default implementation just returns empty list
@@ -15,6 +17,14 @@ bool GeneralProcessor::isReadyToProcess() const {
     return true; // Always ready to process by default
 }
 
+void GeneralProcessor::skipProcessing() {
+    // Nothing to skip by default
+}
+
+void GeneralProcessor::stop() {
+    // Nothing runs in the background by default
+}
+
 void GeneralProcessor::setVerbose(int verboseLevel) {
     verbose = verboseLevel;
 }
@@ -27,6 +37,18 @@ void GeneralProcessor::setPeriod(int newPeriod) {
     period = newPeriod;
 }
 
+std::chrono::steady_clock::time_point GeneralProcessor::getNextProcessTime() const {
+    return lastProcessTime + std::chrono::milliseconds(getPeriod());
+}
+
+void GeneralProcessor::setLastProcessTime(std::chrono::steady_clock::time_point processTime) {
+    lastProcessTime = processTime;
+}
+
+void GeneralProcessor::setReadyCallback(std::function<void()> callback) {
+    readyCallback = std::move(callback);
+}
+
 GeneralProcessor::~GeneralProcessor() {
     // Destructor
 }
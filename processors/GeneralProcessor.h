@@ -4,6 +4,8 @@
 
 #include <string>
 #include <vector>
+#include <chrono>
+#include <functional>
 
 /**
  * @brief An abstract base class representing a general processor.
@@ -47,6 +49,22 @@ public:
      */
     virtual bool isReadyToProcess() const;
 
+    /**
+     * @brief Lets a due processing pass without producing any output.
+     * @details Called instead of getProcessedOutput while the data channel ignores its
+     * publishes, so the work is not done at all. By default there is nothing to skip.
+     * @see DataChannelProcessesManager::skipProcesses()
+     */
+    virtual void skipProcessing();
+
+    /**
+     * @brief Stops work the processor does in the background.
+     * @details Called when the processor's data channel is removed, after which the processor
+     * is never run again. By default there is nothing to stop.
+     * @see DataChannelProcessesManager::stopProcessors()
+     */
+    virtual void stop();
+
     /**
      * @brief Sets the verbosity level for logging.
      * @param verboseLevel The new verbosity level.
@@ -65,9 +83,36 @@ public:
      */
     virtual void setPeriod(int newPeriod);
 
+    /**
+     * @brief Gets the time at which the processor is next due to process.
+     * @return The next processing time.
+     * @details Used by the scheduler to decide when to wake up the processor's data channel.
+     * By default this is one period after the last time the processor produced output.
+     * @see DataChannelProcessesManager::getNextProcessTime()
+     */
+    virtual std::chrono::steady_clock::time_point getNextProcessTime() const;
+
+    /**
+     * @brief Records the time at which the processor last produced output.
+     * @param processTime The time the processor was run.
+     * @see DataChannelProcessesManager::runProcesses()
+     */
+    void setLastProcessTime(std::chrono::steady_clock::time_point processTime);
+
+    /**
+     * @brief Sets the callback used to report output that became ready outside of the regular period.
+     * @param callback Function that reschedules the processor's data channel.
+     * @details Processors that produce output asynchronously call this so their data channel
+     * is published right away instead of at the next period.
+     * @see DataChannelManager::addChannel
+     */
+    void setReadyCallback(std::function<void()> callback);
+
 protected:
     int verbose; ///< Verbosity level for logging.
     int period;  ///< Processing period.
+    std::chrono::steady_clock::time_point lastProcessTime; ///< Time the processor was last run.
+    std::function<void()> readyCallback; ///< Reports output that became ready asynchronously.
 };
 
 #endif // GENERAL_PROCESSOR_H
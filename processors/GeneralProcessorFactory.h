@@ -30,7 +30,7 @@ public:
     /**
      * @brief Creates an instance of GeneralProcessor based on the provided processor type.
      * @param processorType The type identifier for the processor.
-     * @return Pointer to the created GeneralProcessor instance.
+     * @return Pointer to the created GeneralProcessor instance, owned by the caller.
      */
     GeneralProcessor* CreateProcessor(const std::string& processorType) const;
 
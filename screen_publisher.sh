@@ -48,11 +48,8 @@ setup_script="$script_directory/environment_setup/setup_environment.sh"
 # Define a log file for output
 log_file="$script_directory/midas_publisher.log"
 
-# Kill all instances of the screen session
-screen -ls | grep -oE "[0-9]+\.$screen_session_name" | while read -r session; do
-    echo "Killing existing screen session '$session'..."
-    screen -S "$session" -X quit
-done
+# Stop all instances of the screen session, waiting for the publisher to release its ports
+"$script_directory/stop_publisher_screen.sh"
 
 # Create a new screen session
 screen -S "$screen_session_name" -d -m
@@ -1,10 +1,49 @@
 #!/bin/bash
 
-# Send a Ctrl+C to the screen session
-screen -S midas_publisher -X stuff "^C"
+# Define the name for the screen session
+screen_session_name="midas_publisher"
 
-# Wait for a short time (adjust the duration as needed)
-sleep 1
+# Seconds to wait for the publisher to exit before signalling it directly
+exit_timeout=10
 
-# Kill the screen session
-screen -X -S midas_publisher quit
+# Wait until none of the given processes runs anymore, or the timeout in seconds passes
+wait_for_exit() {
+    local timeout=$1
+    shift
+    for (( i = 0; i < timeout * 10; i++ )); do
+        local running=false
+        for pid in "$@"; do
+            kill -0 "$pid" 2>/dev/null && running=true
+        done
+        [ "$running" = false ] && return 0
+        sleep 0.1
+    done
+    return 1
+}
+
+# Stop the publisher in every screen session of that name, then close the session
+screen -ls | grep -oE "[0-9]+\.$screen_session_name" | while read -r session; do
+    echo "Stopping screen session '$session'..."
+
+    # The publisher runs in a shell of the session, which is a child of the screen process
+    publisher_pids=()
+    for shell_pid in $(pgrep -P "${session%%.*}"); do
+        publisher_pids+=($(pgrep -x -P "$shell_pid" publisher))
+    done
+
+    # The publisher reloads its config on SIGHUP, so closing the session would not stop it
+    screen -S "$session" -X stuff "^C"
+    if [ ${#publisher_pids[@]} -gt 0 ] && ! wait_for_exit "$exit_timeout" "${publisher_pids[@]}"; then
+        echo "Publisher did not exit after Ctrl+C, sending SIGTERM..."
+        kill -TERM "${publisher_pids[@]}" 2>/dev/null
+        if ! wait_for_exit "$exit_timeout" "${publisher_pids[@]}"; then
+            # Still running, e.g. blocked in a command, and it would keep its ports bound
+            echo "Publisher did not exit after SIGTERM, killing it..."
+            kill -KILL "${publisher_pids[@]}" 2>/dev/null
+            wait_for_exit "$exit_timeout" "${publisher_pids[@]}"
+        fi
+    fi
+
+    # Kill the screen session
+    screen -S "$session" -X quit
+done
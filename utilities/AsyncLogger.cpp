@@ -0,0 +1,152 @@
+#include "AsyncLogger.h"
+#include <iostream>
+
+// Time the writer sleeps between batches, producers only wake it early when the buffer fills up
+const int WRITER_SLEEP_MS = 10;
+
+AsyncLogger::AsyncLogger()
+    : mask(0), writePosition(0), readPosition(0), running(false), writerSleeping(false), activeWriters(0), droppedCount(0) {}
+
+AsyncLogger& AsyncLogger::Instance() {
+    // Never destroyed, printers may still run during static destruction
+    static AsyncLogger* instance = new AsyncLogger();
+    return *instance;
+}
+
+bool AsyncLogger::start(size_t capacity) {
+    if (running.load() || writerThread.joinable()) {
+        return false;
+    }
+
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    slots.reset(new Slot[size]);
+    for (size_t i = 0; i < size; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mask = size - 1;
+    writePosition = 0;
+    readPosition = 0;
+
+    running = true;
+    writerThread = std::thread(&AsyncLogger::writerLoop, this);
+    return true;
+}
+
+void AsyncLogger::stop() {
+    if (!writerThread.joinable()) {
+        return;
+    }
+    running = false;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCondition.notify_one();
+    }
+    writerThread.join();
+
+    // Producers that saw the logger running may still be adding lines after the writer's last batch
+    while (activeWriters.load() > 0) {
+        std::this_thread::yield();
+    }
+    writeAvailable();
+}
+
+bool AsyncLogger::isRunning() const {
+    return running.load();
+}
+
+bool AsyncLogger::write(const std::string& line) {
+    // Announce the write before checking running, so stop() either waits for it or the caller writes the line
+    activeWriters.fetch_add(1);
+    if (!running.load()) {
+        activeWriters.fetch_sub(1);
+        return false;
+    }
+    push(line);
+    activeWriters.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void AsyncLogger::push(const std::string& line) {
+    // Claim a slot, a slot whose sequence lags behind its position has not been read yet
+    size_t position = writePosition.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = slots[position & mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.line = line;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                break;
+            }
+        } else if (sequence < position) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = writePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Waking the writer costs a system call, only do it when the buffer is half full
+    bool halfFull = position + 1 - readPosition.load(std::memory_order_relaxed) > (mask + 1) / 2;
+    if (halfFull && writerSleeping.load() && writerSleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCondition.notify_one();
+    }
+}
+
+uint64_t AsyncLogger::getDroppedCount() const {
+    return droppedCount.load();
+}
+
+bool AsyncLogger::tryTake(std::string& line) {
+    size_t position = readPosition.load(std::memory_order_relaxed);
+    Slot& slot = slots[position & mask];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+    line.swap(slot.line);
+    slot.line.clear();
+    slot.sequence.store(position + mask + 1, std::memory_order_release);
+    readPosition.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void AsyncLogger::writeAvailable() {
+    std::string line;
+    bool wroteAny = false;
+    while (tryTake(line)) {
+        std::cout << line << '\n';
+        wroteAny = true;
+    }
+    if (wroteAny) {
+        std::cout.flush();
+    }
+}
+
+void AsyncLogger::writerLoop() {
+    uint64_t reportedDrops = 0;
+    while (running.load()) {
+        writeAvailable();
+
+        uint64_t dropped = droppedCount.load();
+        if (dropped != reportedDrops) {
+            std::cout << "[AsyncLogger] " << (dropped - reportedDrops) << " log line(s) dropped, the log buffer was full" << std::endl;
+            reportedDrops = dropped;
+        }
+
+        // Sleep until the next batch, or until a producer finds the buffer half full
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (!running.load()) {
+            break;
+        }
+        writerSleeping = true;
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(WRITER_SLEEP_MS));
+        writerSleeping = false;
+    }
+
+    // Write what is left so stopping does not lose lines
+    writeAvailable();
+}
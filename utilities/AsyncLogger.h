@@ -0,0 +1,115 @@
+// AsyncLogger.h
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+/**
+ * @brief Writes log lines to stdout from a background thread.
+ *
+ * The `AsyncLogger` class keeps a fixed size lock-free ring buffer of formatted lines. Any
+ * thread can add lines without blocking and without doing I/O, and a background thread
+ * writes them to stdout in batches every few milliseconds, or sooner when the buffer fills up.
+ * When the ring buffer is full new lines are dropped and counted, the writer reports how many
+ * were lost. It is designed as a singleton that is never
+ * destroyed, so printing stays safe during static destruction; call \ref stop before exiting
+ * to write the remaining lines.
+ */
+class AsyncLogger {
+public:
+    /**
+     * @brief Gets the singleton instance of AsyncLogger.
+     * @return Reference to the singleton instance.
+     */
+    static AsyncLogger& Instance();
+
+    /**
+     * @brief Starts the background writer thread.
+     * @param capacity Number of lines the ring buffer holds, rounded up to a power of two.
+     * @return True if started, false if it was already running.
+     */
+    bool start(size_t capacity);
+
+    /**
+     * @brief Writes the remaining lines and stops the background thread.
+     * @details Lines added afterwards are written directly by their callers again.
+     */
+    void stop();
+
+    /**
+     * @brief Checks if the background writer thread is running.
+     * @return True if running, false otherwise.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Hands a line to the background writer.
+     * @param line The formatted line, without the trailing newline.
+     * @return True if the logger took care of the line (written later or dropped because the
+     * ring buffer is full), false if it is not running and the caller has to write it.
+     */
+    bool write(const std::string& line);
+
+    /**
+     * @brief Gets the number of lines dropped because the ring buffer was full.
+     * @return The number of dropped lines.
+     */
+    uint64_t getDroppedCount() const;
+
+private:
+    /**
+     * @brief Private constructor for AsyncLogger.
+     */
+    AsyncLogger();
+
+    /**
+     * @brief One line of the ring buffer.
+     */
+    struct Slot {
+        std::atomic<size_t> sequence; ///< Position the slot is ready for: to write when equal to it, to read when one past it.
+        std::string line;             ///< The formatted line.
+    };
+
+    std::unique_ptr<Slot[]> slots; ///< The ring buffer.
+    size_t mask; ///< Ring buffer size minus one, for wrapping positions.
+    std::atomic<size_t> writePosition; ///< Next position claimed by a producer.
+    std::atomic<size_t> readPosition; ///< Next position read by the writer thread.
+    std::atomic<bool> running; ///< Flag indicating the writer thread runs and lines are accepted.
+    std::atomic<bool> writerSleeping; ///< Flag indicating the writer thread sleeps and can be woken up early.
+    std::atomic<int> activeWriters; ///< Producers currently inside write(), stop() waits for them.
+    std::atomic<uint64_t> droppedCount; ///< Lines dropped because the ring buffer was full.
+    std::mutex wakeMutex; ///< Protects sleeping on wakeCondition.
+    std::condition_variable wakeCondition; ///< Wakes the writer thread when the buffer fills up or it should stop.
+    std::thread writerThread; ///< The background writer thread.
+
+    /**
+     * @brief Adds a line to the ring buffer, or counts it as dropped if the buffer is full.
+     * @param line The formatted line, without the trailing newline.
+     */
+    void push(const std::string& line);
+
+    /**
+     * @brief Takes the oldest line from the ring buffer. Only called by the writer thread, or by stop() after joining it.
+     * @param line Receives the line.
+     * @return True if a line was taken, false if the ring buffer is empty.
+     */
+    bool tryTake(std::string& line);
+
+    /**
+     * @brief Writes all lines in the ring buffer to stdout.
+     */
+    void writeAvailable();
+
+    /**
+     * @brief Writes lines until stopped.
+     */
+    void writerLoop();
+};
+
+#endif // ASYNCLOGGER_H
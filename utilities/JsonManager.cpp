@@ -24,9 +24,9 @@ JsonManager::JsonManager(const std::string& configFile) : configFilePath(configF
 }
 
 void JsonManager::loadConfigFile() {
-    // Load the JSON configuration from the file and replace environment variables
-    config = readConfigFile(configFilePath);
-    config = replaceEnvironmentVariables(config);
+    // Load the JSON configuration from the file and replace environment variables,
+    // the previous configuration is kept if either fails
+    config = replaceEnvironmentVariables(readConfigFile(configFilePath));
 }
 
 const nlohmann::json& JsonManager::getConfig() const {
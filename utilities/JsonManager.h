@@ -26,6 +26,8 @@ public:
 
     /**
      * @brief Loads the configuration from the specified JSON file.
+     * @throws std::runtime_error if the file cannot be read or parsed, or an environment
+     * variable is missing. The previously loaded configuration is kept in that case.
      */
     void loadConfigFile();
 
@@ -0,0 +1,155 @@
+// LatencyHistogram.h
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief A point in time copy of a \ref LatencyHistogram, used to compute percentiles.
+ */
+class HistogramSnapshot {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;                      ///< Sub-buckets per power of two, as bits.
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;       ///< Sub-buckets per power of two.
+    static constexpr int MAX_EXPONENT = 40;                        ///< Values from 2^40 ns (about 18 minutes) share the last bucket.
+    static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS; ///< Number of buckets.
+
+    std::array<uint64_t, BUCKET_COUNT> counts{}; ///< Samples per bucket.
+    uint64_t count = 0; ///< Number of samples.
+    uint64_t sumNs = 0; ///< Sum of all samples in ns.
+
+    /**
+     * @brief Gets the bucket a value falls into.
+     * @param valueNs The value in ns.
+     * @return Index of the bucket.
+     * @details Values below 16 ns have a bucket each, above that every power of two is split
+     * into 16 linear sub-buckets, so every value is known to within 1/16 (about 6%).
+     */
+    static size_t BucketIndex(uint64_t valueNs) {
+        if (valueNs < static_cast<uint64_t>(SUB_BUCKETS)) {
+            return static_cast<size_t>(valueNs);
+        }
+        int exponent = 63 - __builtin_clzll(valueNs);
+        if (exponent > MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        size_t subBucket = (valueNs >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+    }
+
+    /**
+     * @brief Gets the value a bucket stands for.
+     * @param index Index of the bucket.
+     * @return The middle of the bucket's range in ns.
+     */
+    static uint64_t BucketValue(size_t index) {
+        if (index < static_cast<size_t>(SUB_BUCKETS)) {
+            return index;
+        }
+        int exponent = static_cast<int>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+        uint64_t lowerBound = (static_cast<uint64_t>(SUB_BUCKETS) + index % SUB_BUCKETS) << (exponent - SUB_BUCKET_BITS);
+        return lowerBound + ((1ULL << (exponent - SUB_BUCKET_BITS)) >> 1);
+    }
+
+    /**
+     * @brief Gets a percentile of the samples.
+     * @param percentile The percentile, between 0 and 100.
+     * @return The value in ns, 0 without samples.
+     */
+    uint64_t GetPercentile(double percentile) const {
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * count + 0.5);
+        rank = rank < 1 ? 1 : (rank > count ? count : rank);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return BucketValue(i);
+            }
+        }
+        return BucketValue(BUCKET_COUNT - 1);
+    }
+
+    /**
+     * @brief Gets the largest sample.
+     * @return The value of the highest non-empty bucket in ns, 0 without samples.
+     */
+    uint64_t GetMax() const {
+        for (size_t i = BUCKET_COUNT; i > 0; --i) {
+            if (counts[i - 1] > 0) {
+                return BucketValue(i - 1);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Gets the mean of the samples.
+     * @return The mean in ns, 0 without samples.
+     */
+    double GetMean() const {
+        return count > 0 ? static_cast<double>(sumNs) / count : 0.0;
+    }
+
+    /**
+     * @brief Gets the samples recorded since an earlier snapshot of the same histogram.
+     * @param earlier The earlier snapshot.
+     * @return Snapshot of only the samples in between.
+     */
+    HistogramSnapshot Since(const HistogramSnapshot& earlier) const {
+        HistogramSnapshot difference;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            difference.counts[i] = counts[i] - earlier.counts[i];
+        }
+        difference.count = count - earlier.count;
+        difference.sumNs = sumNs - earlier.sumNs;
+        return difference;
+    }
+};
+
+/**
+ * @brief Records latencies into log-linear buckets, like an HDR histogram.
+ *
+ * The `LatencyHistogram` class keeps a fixed array of counters covering 1 ns to about 18
+ * minutes with a relative error of at most 1/16. Recording is a handful of instructions and
+ * two relaxed atomic additions, so it can be called from any thread on the publishing path,
+ * and percentiles are read from a \ref HistogramSnapshot without stopping the recorders.
+ * @details Counters only grow. Interval statistics are the difference of two snapshots,
+ * see \ref HistogramSnapshot::Since.
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @brief Records a sample.
+     * @param valueNs The latency in ns.
+     */
+    void Record(uint64_t valueNs) {
+        counts[HistogramSnapshot::BucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+        sumNs.fetch_add(valueNs, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Copies the counters.
+     * @return The snapshot, the sum may include samples recorded while copying.
+     */
+    HistogramSnapshot TakeSnapshot() const {
+        HistogramSnapshot snapshot;
+        for (size_t i = 0; i < HistogramSnapshot::BUCKET_COUNT; ++i) {
+            snapshot.counts[i] = counts[i].load(std::memory_order_relaxed);
+            snapshot.count += snapshot.counts[i];
+        }
+        snapshot.sumNs = sumNs.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::BUCKET_COUNT> counts{}; ///< Samples per bucket.
+    std::atomic<uint64_t> sumNs{0}; ///< Sum of all samples in ns.
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,64 @@
+// Logging.h
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include "ProjectPrinter.h"
+
+/**
+ * @file Logging.h
+ * @brief Verbosity gated logging that costs nothing when disabled.
+ *
+ * Verbose messages are only built when the runtime verbosity asks for them, the message
+ * argument of the macros is not evaluated otherwise. Levels above PUBLISHER_MAX_VERBOSE are
+ * removed at compile time, so a build with -DPUBLISHER_MAX_VERBOSE=0 has no verbose logging
+ * code in its hot paths at all.
+ */
+
+#ifndef PUBLISHER_MAX_VERBOSE
+#define PUBLISHER_MAX_VERBOSE 3 ///< Highest verbose level compiled in.
+#endif
+
+/**
+ * @brief Checks if messages of a verbose level are printed.
+ * @tparam Level The verbose level of the message.
+ * @param verbose The runtime verbosity.
+ * @return True if the message should be built and printed, false otherwise. Always false
+ * for levels above PUBLISHER_MAX_VERBOSE, so the guarded code is compiled away.
+ */
+template <int Level>
+constexpr bool isVerboseEnabled(int verbose) {
+    if constexpr (Level > PUBLISHER_MAX_VERBOSE) {
+        return false;
+    } else {
+        return verbose >= Level;
+    }
+}
+
+/**
+ * @brief Prints a message if the verbosity is at least the given level.
+ * @param verbose The runtime verbosity.
+ * @param level The verbose level of the message, must be a constant.
+ * @param message Expression building the message, only evaluated when printed.
+ */
+#define LOG_VERBOSE(verbose, level, message)              \
+    do {                                                  \
+        if constexpr ((level) <= PUBLISHER_MAX_VERBOSE) { \
+            if ((verbose) >= (level)) {                   \
+                ProjectPrinter().Print(message);          \
+            }                                             \
+        }                                                 \
+    } while (0)
+
+/**
+ * @brief Prints a warning with the current file and line.
+ * @param message The warning message.
+ */
+#define LOG_WARNING(message) ProjectPrinter().PrintWarning((message), __LINE__, __FILE__)
+
+/**
+ * @brief Prints an error with the current file and line.
+ * @param message The error message.
+ */
+#define LOG_ERROR(message) ProjectPrinter().PrintError((message), __LINE__, __FILE__)
+
+#endif // LOGGING_H
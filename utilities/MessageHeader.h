@@ -0,0 +1,233 @@
+// MessageHeader.h
+#ifndef MESSAGEHEADER_H
+#define MESSAGEHEADER_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <chrono>
+
+/**
+ * @brief Encodings a data channel can serialize its payload with.
+ */
+enum class SerializationFormat : uint8_t {
+    Json = 0,        ///< JSON text, the default.
+    MessagePack = 1, ///< MessagePack binary encoding.
+    Cbor = 2         ///< CBOR (RFC 8949) binary encoding.
+};
+
+/**
+ * @brief Codecs a payload can be compressed with.
+ */
+enum class CompressionCodec : uint8_t {
+    None = 0, ///< The payload is not compressed.
+    Lz4 = 1,  ///< LZ4 block format.
+    Zstd = 2  ///< Zstandard frame format.
+};
+
+/**
+ * @brief Describes the payload of a published message.
+ *
+ * The `MessageHeader` class is sent as its own frame between the topic frame and the payload
+ * frame, so receivers know how to decode the payload without knowing the publisher's config,
+ * can detect lost messages by gaps in the sequence number and can measure the delivery latency.
+ * Uncompressed JSON channels only send it when the channel enables its header frame, otherwise
+ * their messages look as before.
+ * @details The header is a small binary frame of big endian fields:
+ * | Offset | Size | Field                                                                |
+ * |--------|------|----------------------------------------------------------------------|
+ * | 0      | 2    | Magic bytes "PH"                                                     |
+ * | 2      | 1    | Layout version                                                       |
+ * | 3      | 1    | Serialization format                                                 |
+ * | 4      | 1    | Compression codec                                                    |
+ * | 5      | 4    | Uncompressed payload size                                            |
+ * | 9      | 8    | Per channel message sequence number, starting at 1                   |
+ * | 17     | 8    | Monotonic time the processors produced the data, in ns               |
+ * | 25     | 8    | Wall clock time the processors produced the data, in ns since the Unix epoch |
+ * | 33     | 8    | Monotonic time the message was handed to the socket, in ns           |
+ * | 41     | 8    | Wall clock time the message was handed to the socket, in ns since the Unix epoch |
+ *
+ * Monotonic times are only comparable on the publishing host. Receivers can tell the header
+ * apart from a payload by \ref IsHeaderFrame.
+ */
+class MessageHeader {
+public:
+    static constexpr uint8_t VERSION = 1; ///< Version of the header layout written and read by this publisher.
+    static constexpr size_t SIZE = 49;    ///< Size of an encoded header in bytes.
+
+    SerializationFormat format = SerializationFormat::Json; ///< Encoding of the payload.
+    CompressionCodec compression = CompressionCodec::None;  ///< Codec the payload is compressed with.
+    uint32_t uncompressedSize = 0;     ///< Size of the payload before compression, 0 if not compressed.
+    uint64_t sequence = 0;             ///< Per channel message sequence number, 0 if unknown.
+    uint64_t processedMonotonicNs = 0; ///< Monotonic time the processors produced the data.
+    uint64_t processedWallNs = 0;      ///< Wall clock time the processors produced the data.
+    uint64_t sentMonotonicNs = 0;      ///< Monotonic time the message was handed to the socket.
+    uint64_t sentWallNs = 0;           ///< Wall clock time the message was handed to the socket.
+
+    /**
+     * @brief Encodes the header into a frame.
+     * @return The encoded header.
+     */
+    std::string Encode() const {
+        std::string frame(SIZE, '\0');
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(&frame[0]);
+        bytes[0] = MAGIC[0];
+        bytes[1] = MAGIC[1];
+        bytes[2] = VERSION;
+        bytes[3] = static_cast<uint8_t>(format);
+        bytes[4] = static_cast<uint8_t>(compression);
+        WriteBigEndian(bytes + 5, uncompressedSize, 4);
+        WriteBigEndian(bytes + 9, sequence, 8);
+        WriteBigEndian(bytes + 17, processedMonotonicNs, 8);
+        WriteBigEndian(bytes + 25, processedWallNs, 8);
+        WriteBigEndian(bytes + 33, sentMonotonicNs, 8);
+        WriteBigEndian(bytes + 41, sentWallNs, 8);
+        return frame;
+    }
+
+    /**
+     * @brief Writes the current time as the send time into an encoded header.
+     * @param data The encoded header, changed in place.
+     * @param size The frame size in bytes.
+     * @details Called right before the frame is handed to the socket, so the send time
+     * excludes the time the message waited in a send queue. Frames of another layout version
+     * are left unchanged.
+     */
+    static void StampSendTime(void* data, size_t size) {
+        unsigned char* bytes = static_cast<unsigned char*>(data);
+        if (!IsHeaderFrame(data, size) || bytes[2] != VERSION) {
+            return;
+        }
+        WriteBigEndian(bytes + 33, MonotonicNowNs(), 8);
+        WriteBigEndian(bytes + 41, WallNowNs(), 8);
+    }
+
+    /**
+     * @brief Gets the current monotonic time as used in the header.
+     * @return Nanoseconds of std::chrono::steady_clock.
+     */
+    static uint64_t MonotonicNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Gets the current wall clock time as used in the header.
+     * @return Nanoseconds since the Unix epoch.
+     */
+    static uint64_t WallNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Checks if a frame is a message header.
+     * @param data The frame data.
+     * @param size The frame size in bytes.
+     * @return True if the frame has the header size and starts with the header magic bytes,
+     * false otherwise.
+     */
+    static bool IsHeaderFrame(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        return size == SIZE && bytes[0] == MAGIC[0] && bytes[1] == MAGIC[1];
+    }
+
+    /**
+     * @brief Decodes a header frame.
+     * @param data The frame data.
+     * @param size The frame size in bytes.
+     * @return The decoded header.
+     * @throws std::runtime_error if the frame is not a header, has another layout version or
+     * uses an unknown format or codec.
+     */
+    static MessageHeader Decode(const void* data, size_t size) {
+        if (!IsHeaderFrame(data, size)) {
+            throw std::runtime_error("Frame is not a message header");
+        }
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        if (bytes[2] != VERSION) {
+            throw std::runtime_error("Unsupported message header version: " + std::to_string(bytes[2]));
+        }
+        if (bytes[3] > static_cast<uint8_t>(SerializationFormat::Cbor)) {
+            throw std::runtime_error("Unknown serialization format in message header: " + std::to_string(bytes[3]));
+        }
+        if (bytes[4] > static_cast<uint8_t>(CompressionCodec::Zstd)) {
+            throw std::runtime_error("Unknown compression codec in message header: " + std::to_string(bytes[4]));
+        }
+        MessageHeader header;
+        header.format = static_cast<SerializationFormat>(bytes[3]);
+        header.compression = static_cast<CompressionCodec>(bytes[4]);
+        header.uncompressedSize = static_cast<uint32_t>(ReadBigEndian(bytes + 5, 4));
+        header.sequence = ReadBigEndian(bytes + 9, 8);
+        header.processedMonotonicNs = ReadBigEndian(bytes + 17, 8);
+        header.processedWallNs = ReadBigEndian(bytes + 25, 8);
+        header.sentMonotonicNs = ReadBigEndian(bytes + 33, 8);
+        header.sentWallNs = ReadBigEndian(bytes + 41, 8);
+        return header;
+    }
+
+    /**
+     * @brief Parses a serialization format name from the config.
+     * @param name One of "json", "msgpack" or "cbor".
+     * @return The matching serialization format.
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static SerializationFormat ParseFormat(const std::string& name) {
+        if (name == "json") {
+            return SerializationFormat::Json;
+        }
+        if (name == "msgpack") {
+            return SerializationFormat::MessagePack;
+        }
+        if (name == "cbor") {
+            return SerializationFormat::Cbor;
+        }
+        throw std::runtime_error("Unknown serialization format: " + name);
+    }
+
+    /**
+     * @brief Gets the config name of a serialization format.
+     * @param format The serialization format.
+     * @return The name accepted by \ref ParseFormat.
+     */
+    static std::string GetFormatName(SerializationFormat format) {
+        switch (format) {
+            case SerializationFormat::MessagePack:
+                return "msgpack";
+            case SerializationFormat::Cbor:
+                return "cbor";
+            default:
+                return "json";
+        }
+    }
+
+private:
+    static constexpr const char* MAGIC = "PH"; ///< Bytes every header frame starts with.
+
+    /**
+     * @brief Writes an unsigned integer in network byte order.
+     * @param bytes Where to write.
+     * @param value The value to write.
+     * @param count Number of bytes to write.
+     */
+    static void WriteBigEndian(unsigned char* bytes, uint64_t value, int count) {
+        for (int i = 0; i < count; ++i) {
+            bytes[i] = static_cast<unsigned char>((value >> (8 * (count - 1 - i))) & 0xff);
+        }
+    }
+
+    /**
+     * @brief Reads an unsigned integer in network byte order.
+     * @param bytes Where to read.
+     * @param count Number of bytes to read.
+     * @return The value.
+     */
+    static uint64_t ReadBigEndian(const unsigned char* bytes, int count) {
+        uint64_t value = 0;
+        for (int i = 0; i < count; ++i) {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+};
+
+#endif // MESSAGEHEADER_H
@@ -0,0 +1,135 @@
+#include "MetricsServer.h"
+#include "Logging.h"
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+
+// Longest request header read and longest wait for it, scrapers send a few hundred bytes at once
+const size_t MAX_REQUEST_BYTES = 8192;
+const int REQUEST_TIMEOUT_MS = 1000;
+
+MetricsServer::MetricsServer(int verbose) : verbose(verbose), listenFd(-1), wakeFd(-1), running(false) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(const std::string& bindAddress, int port, std::function<std::string()> render) {
+    if (running) {
+        return false;
+    }
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bindAddress.c_str(), &address.sin_addr) != 1) {
+        LOG_ERROR("Invalid metrics bind address " + bindAddress);
+        return false;
+    }
+
+    // Restarting right after a stop must not fail on connections still in TIME_WAIT
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    if (listenFd < 0 || setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 16) != 0) {
+        LOG_ERROR("Failed to listen for metrics on " + bindAddress + ":" + std::to_string(port) + ": " + std::strerror(errno));
+        if (listenFd >= 0) {
+            close(listenFd);
+            listenFd = -1;
+        }
+        return false;
+    }
+
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    renderFunction = std::move(render);
+    running = true;
+    serverThread = std::thread(&MetricsServer::serverLoop, this);
+    LOG_VERBOSE(verbose, 1, "Serving metrics on http://" + bindAddress + ":" + std::to_string(port) + "/metrics");
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written; // The poll timeout ends the loop anyway
+    serverThread.join();
+    close(listenFd);
+    close(wakeFd);
+    listenFd = -1;
+    wakeFd = -1;
+}
+
+bool MetricsServer::isRunning() const {
+    return running.load();
+}
+
+void MetricsServer::serverLoop() {
+    pollfd fds[2] = {{listenFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+    while (running) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("Metrics server stopped: " + std::string(std::strerror(errno)));
+            return;
+        }
+        if (fds[1].revents & POLLIN) {
+            return;
+        }
+        if (fds[0].revents & POLLIN) {
+            int clientFd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (clientFd >= 0) {
+                handleConnection(clientFd);
+                close(clientFd);
+            }
+        }
+    }
+}
+
+void MetricsServer::handleConnection(int clientFd) {
+    // Read up to the end of the request header, the body of a GET is empty
+    std::string request;
+    char buffer[1024];
+    pollfd fd = {clientFd, POLLIN, 0};
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+        if (poll(&fd, 1, REQUEST_TIMEOUT_MS) <= 0) {
+            return;
+        }
+        ssize_t received = recv(clientFd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            return;
+        }
+        request.append(buffer, received);
+    }
+
+    std::string status = "200 OK";
+    std::string contentType = "text/plain; version=0.0.4; charset=utf-8";
+    std::string body;
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0) {
+        body = renderFunction();
+    } else {
+        status = "404 Not Found";
+        contentType = "text/plain; charset=utf-8";
+        body = "Metrics are served at /metrics\n";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\nContent-Type: " + contentType + "\r\nContent-Length: " +
+                           std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = send(clientFd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return;
+        }
+        sent += written;
+    }
+}
@@ -0,0 +1,75 @@
+// MetricsServer.h
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief Serves metrics over HTTP from a background thread.
+ *
+ * The `MetricsServer` class answers `GET /metrics` on a TCP port with the text returned by a
+ * render function, so Prometheus or curl can watch the publisher without subscribing to any
+ * data channel. Every other path gets a 404. It handles one short request per connection,
+ * which is all a scraper needs, and never touches the publishing threads.
+ * @see MetricsRegistry::renderPrometheus
+ */
+class MetricsServer {
+public:
+    /**
+     * @brief Constructor for MetricsServer.
+     * @param verbose Verbosity level for logging (default is 0).
+     */
+    MetricsServer(int verbose = 0);
+
+    /**
+     * @brief Destructor for MetricsServer. Stops the server thread.
+     */
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Binds the port and starts serving.
+     * @param bindAddress IPv4 address to listen on, 127.0.0.1 keeps the endpoint local.
+     * @param port TCP port to listen on.
+     * @param render Function returning the metrics text, called on the server thread.
+     * @return True if listening, false if the address could not be bound or it already runs.
+     */
+    bool start(const std::string& bindAddress, int port, std::function<std::string()> render);
+
+    /**
+     * @brief Stops serving and closes the port.
+     */
+    void stop();
+
+    /**
+     * @brief Checks if the server thread is running.
+     * @return True if running, false otherwise.
+     */
+    bool isRunning() const;
+
+private:
+    int verbose; ///< Verbosity level for logging.
+    int listenFd; ///< Listening socket, -1 when stopped.
+    int wakeFd; ///< Eventfd that wakes the server thread to stop, -1 when stopped.
+    std::atomic<bool> running; ///< Flag indicating the server thread runs.
+    std::function<std::string()> renderFunction; ///< Produces the metrics text.
+    std::thread serverThread; ///< The background server thread.
+
+    /**
+     * @brief Accepts connections until stopped.
+     */
+    void serverLoop();
+
+    /**
+     * @brief Reads one request from a connection and answers it.
+     * @param clientFd The accepted connection, closed by the caller.
+     */
+    void handleConnection(int clientFd);
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,89 @@
+// MpscQueue.h
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/**
+ * @brief A lock-free unbounded multi-producer/single-consumer queue.
+ *
+ * The `MpscQueue` class is an intrusive linked list queue in which producers only swap the
+ * head pointer, so pushing never blocks and never waits for the consumer. Only one thread may
+ * pop. A push that is in progress may briefly be invisible to the consumer, which then sees
+ * the queue as empty; the producer should wake the consumer after pushing.
+ *
+ * @tparam T The type of the queued items, must be default constructible and movable.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    /**
+     * @brief Constructor for MpscQueue.
+     */
+    MpscQueue() : head(new Node()), tail(head.load(std::memory_order_relaxed)) {}
+
+    /**
+     * @brief Destructor for MpscQueue. Discards the items that were not popped.
+     */
+    ~MpscQueue() {
+        T item;
+        while (pop(item)) {
+        }
+        delete tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Adds an item to the queue. Safe to call from any number of threads.
+     * @param item The item to add.
+     */
+    void push(T item) {
+        Node* node = new Node(std::move(item));
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Removes the oldest item from the queue. Must only be called by the consumer thread.
+     * @param item Receives the removed item.
+     * @return True if an item was removed, false if the queue was empty.
+     */
+    bool pop(T& item) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        // The popped node becomes the new empty stub node
+        item = std::move(next->item);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    /**
+     * @brief Checks if the queue is empty. Must only be called by the consumer thread.
+     * @return True if no item is ready to be popped, false otherwise.
+     */
+    bool empty() const {
+        return tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    /**
+     * @brief A queued item and the link to the next newer one.
+     */
+    struct Node {
+        Node() : next(nullptr) {}
+        explicit Node(T&& item) : item(std::move(item)), next(nullptr) {}
+        T item;                   ///< The queued item (empty for the stub node).
+        std::atomic<Node*> next;  ///< The next newer node, null for the newest.
+    };
+
+    std::atomic<Node*> head; ///< The newest node, swapped by producers.
+    Node* tail;              ///< The stub node before the oldest item, owned by the consumer.
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,136 @@
+#include "PayloadCompressor.h"
+#include <stdexcept>
+#include <memory>
+
+#ifdef PUBLISHER_HAVE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#ifdef PUBLISHER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef PUBLISHER_HAVE_ZSTD
+/**
+ * @brief Gets the Zstandard compression context of the calling thread.
+ * @return The context, created on first use and freed when the thread exits.
+ */
+static ZSTD_CCtx* getCompressionContext() {
+    thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> context(ZSTD_createCCtx(), ZSTD_freeCCtx);
+    return context.get();
+}
+
+/**
+ * @brief Gets the Zstandard decompression context of the calling thread.
+ * @return The context, created on first use and freed when the thread exits.
+ */
+static ZSTD_DCtx* getDecompressionContext() {
+    thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> context(ZSTD_createDCtx(), ZSTD_freeDCtx);
+    return context.get();
+}
+#endif
+
+bool PayloadCompressor::IsAvailable(CompressionCodec codec) {
+    switch (codec) {
+        case CompressionCodec::None:
+            return true;
+#ifdef PUBLISHER_HAVE_LZ4
+        case CompressionCodec::Lz4:
+            return true;
+#endif
+#ifdef PUBLISHER_HAVE_ZSTD
+        case CompressionCodec::Zstd:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+// Parameters are only used by the codecs compiled in
+bool PayloadCompressor::Compress(CompressionCodec codec, [[maybe_unused]] int level, [[maybe_unused]] const std::string& input,
+                                 [[maybe_unused]] std::string& output) {
+    switch (codec) {
+#ifdef PUBLISHER_HAVE_LZ4
+        case CompressionCodec::Lz4: {
+            if (input.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+                return false;
+            }
+            int inputSize = static_cast<int>(input.size());
+            output.resize(LZ4_compressBound(inputSize));
+            int compressedSize = (level > 1)
+                ? LZ4_compress_HC(input.data(), &output[0], inputSize, static_cast<int>(output.size()), level)
+                : LZ4_compress_default(input.data(), &output[0], inputSize, static_cast<int>(output.size()));
+            if (compressedSize <= 0) {
+                return false;
+            }
+            output.resize(compressedSize);
+            return true;
+        }
+#endif
+#ifdef PUBLISHER_HAVE_ZSTD
+        case CompressionCodec::Zstd: {
+            output.resize(ZSTD_compressBound(input.size()));
+            size_t compressedSize = ZSTD_compressCCtx(getCompressionContext(), &output[0], output.size(),
+                                                      input.data(), input.size(), level != 0 ? level : ZSTD_CLEVEL_DEFAULT);
+            if (ZSTD_isError(compressedSize)) {
+                return false;
+            }
+            output.resize(compressedSize);
+            return true;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+bool PayloadCompressor::Decompress(CompressionCodec codec, const void* data, size_t size, [[maybe_unused]] size_t uncompressedSize, std::string& output) {
+    switch (codec) {
+        case CompressionCodec::None:
+            output.assign(static_cast<const char*>(data), size);
+            return true;
+#ifdef PUBLISHER_HAVE_LZ4
+        case CompressionCodec::Lz4: {
+            output.resize(uncompressedSize);
+            int decompressedSize = LZ4_decompress_safe(static_cast<const char*>(data), &output[0],
+                                                       static_cast<int>(size), static_cast<int>(uncompressedSize));
+            return decompressedSize >= 0 && static_cast<size_t>(decompressedSize) == uncompressedSize;
+        }
+#endif
+#ifdef PUBLISHER_HAVE_ZSTD
+        case CompressionCodec::Zstd: {
+            output.resize(uncompressedSize);
+            size_t decompressedSize = ZSTD_decompressDCtx(getDecompressionContext(), &output[0], output.size(), data, size);
+            return !ZSTD_isError(decompressedSize) && decompressedSize == uncompressedSize;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+CompressionCodec PayloadCompressor::ParseCodec(const std::string& name) {
+    if (name == "none") {
+        return CompressionCodec::None;
+    }
+    if (name == "lz4") {
+        return CompressionCodec::Lz4;
+    }
+    if (name == "zstd") {
+        return CompressionCodec::Zstd;
+    }
+    throw std::runtime_error("Unknown compression codec: " + name);
+}
+
+std::string PayloadCompressor::GetCodecName(CompressionCodec codec) {
+    switch (codec) {
+        case CompressionCodec::Lz4:
+            return "lz4";
+        case CompressionCodec::Zstd:
+            return "zstd";
+        default:
+            return "none";
+    }
+}
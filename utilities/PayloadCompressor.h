@@ -0,0 +1,64 @@
+// PayloadCompressor.h
+#ifndef PAYLOADCOMPRESSOR_H
+#define PAYLOADCOMPRESSOR_H
+
+#include <string>
+#include <cstddef>
+#include "MessageHeader.h"
+
+/**
+ * @brief Compresses and decompresses payloads with LZ4 or Zstandard.
+ *
+ * The `PayloadCompressor` class wraps the codecs the publisher was built with. LZ4 is
+ * available when compiled with PUBLISHER_HAVE_LZ4 and Zstandard with PUBLISHER_HAVE_ZSTD,
+ * both are enabled by CMake when the libraries are found.
+ * @details The LZ4 block format does not store the uncompressed size, it is sent in the
+ * \ref MessageHeader instead. Zstandard contexts are reused per thread.
+ */
+class PayloadCompressor {
+public:
+    /**
+     * @brief Checks if a codec was compiled in.
+     * @param codec The compression codec.
+     * @return True if payloads can be compressed with it, false otherwise.
+     */
+    static bool IsAvailable(CompressionCodec codec);
+
+    /**
+     * @brief Compresses a payload.
+     * @param codec The compression codec, must be available.
+     * @param level Compression level, 0 for the codec's default. LZ4 levels above 1 use LZ4 HC.
+     * @param input The payload to compress.
+     * @param output Receives the compressed payload.
+     * @return True if compressed, false if the codec is not available or compression failed.
+     */
+    static bool Compress(CompressionCodec codec, int level, const std::string& input, std::string& output);
+
+    /**
+     * @brief Decompresses a payload.
+     * @param codec The compression codec from the message header.
+     * @param data The compressed payload.
+     * @param size Size of the compressed payload in bytes.
+     * @param uncompressedSize Size of the payload before compression, from the message header.
+     * @param output Receives the decompressed payload.
+     * @return True if decompressed, false if the codec is not available or the data is corrupt.
+     */
+    static bool Decompress(CompressionCodec codec, const void* data, size_t size, size_t uncompressedSize, std::string& output);
+
+    /**
+     * @brief Parses a compression codec name from the config.
+     * @param name One of "none", "lz4" or "zstd".
+     * @return The matching codec.
+     * @throws std::runtime_error if the name is unknown.
+     */
+    static CompressionCodec ParseCodec(const std::string& name);
+
+    /**
+     * @brief Gets the config name of a compression codec.
+     * @param codec The compression codec.
+     * @return The name accepted by \ref ParseCodec.
+     */
+    static std::string GetCodecName(CompressionCodec codec);
+};
+
+#endif // PAYLOADCOMPRESSOR_H
@@ -0,0 +1,125 @@
+// PayloadEncoder.h
+#ifndef PAYLOADENCODER_H
+#define PAYLOADENCODER_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include "MessageHeader.h"
+
+/**
+ * @brief Encodes payload values in the serialization format of a data channel.
+ *
+ * The `PayloadEncoder` class wraps the JSON, MessagePack and CBOR encoders of nlohmann::json
+ * and writes the array and map headers of the binary formats by hand. This way the values of an
+ * array or map can be encoded once and cached, and payloads are put together by concatenating
+ * the cached encodings instead of building and encoding a whole document.
+ */
+class PayloadEncoder {
+public:
+    /**
+     * @brief Encodes a single value.
+     * @param value The value to encode.
+     * @param format The serialization format.
+     * @return The encoded value.
+     */
+    static std::string EncodeValue(const nlohmann::json& value, SerializationFormat format) {
+        std::string encoded;
+        switch (format) {
+            case SerializationFormat::MessagePack:
+                nlohmann::json::to_msgpack(value, encoded);
+                break;
+            case SerializationFormat::Cbor:
+                nlohmann::json::to_cbor(value, encoded);
+                break;
+            default:
+                encoded = value.dump();
+                break;
+        }
+        return encoded;
+    }
+
+    /**
+     * @brief Appends the header of a binary array, its encoded elements follow it directly.
+     * @param output The payload being built.
+     * @param count Number of elements in the array.
+     * @param format MessagePack or CBOR, JSON arrays are written with brackets and commas instead.
+     */
+    static void AppendArrayHeader(std::string& output, size_t count, SerializationFormat format) {
+        if (format == SerializationFormat::MessagePack) {
+            AppendMessagePackHeader(output, count, 0x90, 0xdc);
+        } else {
+            AppendCborHeader(output, count, 0x80);
+        }
+    }
+
+    /**
+     * @brief Appends the header of a binary map, its encoded keys and values follow it alternately.
+     * @param output The payload being built.
+     * @param count Number of key and value pairs in the map.
+     * @param format MessagePack or CBOR, JSON objects are written with braces instead.
+     */
+    static void AppendMapHeader(std::string& output, size_t count, SerializationFormat format) {
+        if (format == SerializationFormat::MessagePack) {
+            AppendMessagePackHeader(output, count, 0x80, 0xde);
+        } else {
+            AppendCborHeader(output, count, 0xa0);
+        }
+    }
+
+private:
+    /**
+     * @brief Appends a MessagePack array or map header.
+     * @param output The payload being built.
+     * @param count Number of elements or pairs.
+     * @param fixType Type byte of the short form holding counts below 16.
+     * @param type16 Type byte of the form with a 16 bit count, the 32 bit form follows it.
+     */
+    static void AppendMessagePackHeader(std::string& output, size_t count, uint8_t fixType, uint8_t type16) {
+        if (count < 16) {
+            output += static_cast<char>(fixType | count);
+        } else if (count <= 0xffff) {
+            output += static_cast<char>(type16);
+            AppendBigEndian(output, count, 2);
+        } else {
+            output += static_cast<char>(type16 + 1);
+            AppendBigEndian(output, count, 4);
+        }
+    }
+
+    /**
+     * @brief Appends a CBOR array or map header.
+     * @param output The payload being built.
+     * @param count Number of elements or pairs.
+     * @param majorType The CBOR major type shifted into the upper three bits.
+     */
+    static void AppendCborHeader(std::string& output, size_t count, uint8_t majorType) {
+        if (count < 24) {
+            output += static_cast<char>(majorType | count);
+        } else if (count <= 0xff) {
+            output += static_cast<char>(majorType | 24);
+            AppendBigEndian(output, count, 1);
+        } else if (count <= 0xffff) {
+            output += static_cast<char>(majorType | 25);
+            AppendBigEndian(output, count, 2);
+        } else {
+            output += static_cast<char>(majorType | 26);
+            AppendBigEndian(output, count, 4);
+        }
+    }
+
+    /**
+     * @brief Appends an unsigned integer in network byte order.
+     * @param output The payload being built.
+     * @param value The value to append.
+     * @param bytes Number of bytes to write.
+     */
+    static void AppendBigEndian(std::string& output, size_t value, int bytes) {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            output += static_cast<char>((value >> shift) & 0xff);
+        }
+    }
+};
+
+#endif // PAYLOADENCODER_H
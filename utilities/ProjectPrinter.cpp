@@ -1,10 +1,15 @@
 #include "ProjectPrinter.h"
+#include "AsyncLogger.h"
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <mutex>
+#include <unordered_map>
 
 ProjectPrinter::ProjectPrinter() {
-    Initialize(getDefaultConfigPath());
+    // The default configuration is read once, the first time a printer is constructed
+    static const std::shared_ptr<const Settings> defaultSettings = LoadSettings(getDefaultConfigPath());
+    settings = defaultSettings;
 }
 
 ProjectPrinter::ProjectPrinter(const std::string& configPath) {
@@ -17,32 +22,68 @@ ProjectPrinter::ProjectPrinter(bool useConfig) {
         Initialize(getDefaultConfigPath());
     } else {
         // Set default options here
-        infoColor = "white";
-        warningColor = "yellow";
-        errorColor = "red";
-        printLineNumber = true;
-        printTime = true;
-        prefix = "";
-        suffix = "";
+        static const std::shared_ptr<const Settings> builtInSettings = []() {
+            auto builtIn = std::make_shared<Settings>();
+            builtIn->infoColor = "white";
+            builtIn->warningColor = "yellow";
+            builtIn->errorColor = "red";
+            builtIn->printLineNumber = true;
+            builtIn->printTime = true;
+            builtIn->prefix = "";
+            builtIn->suffix = "";
+            return std::shared_ptr<const Settings>(builtIn);
+        }();
+        settings = builtInSettings;
     }
 }
 
 void ProjectPrinter::Initialize(const std::string& configPath) {
+    settings = LoadSettings(configPath);
+}
+
+std::shared_ptr<const ProjectPrinter::Settings> ProjectPrinter::LoadSettings(const std::string& configPath) {
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, std::shared_ptr<const Settings>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(configPath);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    nlohmann::json config;
     std::ifstream configFile(configPath);
     configFile >> config;
     configFile.close(); // Close the configuration file
 
+    std::shared_ptr<const Settings> loaded = SettingsFromConfig(config);
+    cache[configPath] = loaded;
+    return loaded;
+}
+
+std::shared_ptr<const ProjectPrinter::Settings> ProjectPrinter::SettingsFromConfig(const nlohmann::json& config) {
+    auto loaded = std::make_shared<Settings>();
+    loaded->config = config;
+
     // Initialize local variables from the configuration
-    infoColor = config["info_color"];
-    warningColor = config["warning_color"];
-    errorColor = config["error_color"];
-    printLineNumber = config["print_line_number"];
-    printTime = config["print_current_time"];
-    prefix = config["prefix"];
-    suffix = config["suffix"];
+    loaded->infoColor = loaded->config["info_color"];
+    loaded->warningColor = loaded->config["warning_color"];
+    loaded->errorColor = loaded->config["error_color"];
+    loaded->printLineNumber = loaded->config["print_line_number"];
+    loaded->printTime = loaded->config["print_current_time"];
+    loaded->prefix = loaded->config["prefix"];
+    loaded->suffix = loaded->config["suffix"];
+    return loaded;
+}
+
+ProjectPrinter::Settings& ProjectPrinter::EditSettings() {
+    // Copy on write, other printers keep the shared settings
+    auto edited = std::make_shared<Settings>(*settings);
+    settings = edited;
+    return *edited;
 }
 
-std::string ProjectPrinter::getDefaultConfigPath() const {
+std::string ProjectPrinter::getDefaultConfigPath() {
     // Get the directory of the source file (ProjectPrinter.cpp)
     std::string sourceDirectory(__FILE__);
     size_t lastSeparator = sourceDirectory.find_last_of('/');
@@ -57,20 +98,25 @@ std::string ProjectPrinter::getDefaultConfigPath() const {
 }
 
 void ProjectPrinter::Print(const std::string& message, int lineNumber, const std::string& filename) const {
-    PrintWithColor(message, "", lineNumber, filename, config["info_color"]);
+    PrintWithColor(message, "", lineNumber, filename, settings->infoColor);
 }
 
 void ProjectPrinter::PrintWarning(const std::string& message, int lineNumber, const std::string& filename) const {
-    PrintWithColor(message, "WARNING", lineNumber, filename, config["warning_color"]);
+    PrintWithColor(message, "WARNING", lineNumber, filename, settings->warningColor);
 }
 
 void ProjectPrinter::PrintError(const std::string& message, int lineNumber, const std::string& filename) const {
-    PrintWithColor(message, "ERROR", lineNumber, filename, config["error_color"]);
+    PrintWithColor(message, "ERROR", lineNumber, filename, settings->errorColor);
 }
 
 void ProjectPrinter::PrintWithColor(const std::string& message, const std::string& status, int lineNumber, const std::string& filename, const std::string& color) const {
     std::string messageString = buildMessageString(message, status, lineNumber, filename);
-    std::cout << colorizeString(messageString, color) << std::endl;
+    std::string line = colorizeString(messageString, color);
+
+    // The terminal is written by the logger thread while it runs
+    if (!AsyncLogger::Instance().write(line)) {
+        std::cout << line << std::endl;
+    }
 }
 
 std::string ProjectPrinter::buildMessageString(const std::string& message, const std::string& status, int lineNumber, const std::string& filename) const {
@@ -83,11 +129,12 @@ std::string ProjectPrinter::buildMessageString(const std::string& message, const
         messageString += "{" + currentTime + "} ";
     }
 
-    if (!getPrefix().empty() || !filename.empty() || lineNumber > 0) {
+    const std::string& prefix = settings->prefix;
+    if (!prefix.empty() || !filename.empty() || lineNumber > 0) {
         messageString += "[";
 
-        if (!getPrefix().empty()) {
-            messageString += getPrefix();
+        if (!prefix.empty()) {
+            messageString += prefix;
         }
 
         if (!status.empty()) {
@@ -125,14 +172,20 @@ std::string ProjectPrinter::getCurrentTime() const{
 
 
 std::string ProjectPrinter::colorizeString(const std::string& message, const std::string& color) const {
-    std::string colorCode = getColorCode(color);
-    std::string resetCode = "\033[0m";
-    return colorCode + message + resetCode;
+    const std::string& colorCode = getColorCode(color);
+    static const std::string resetCode = "\033[0m";
+
+    std::string colored;
+    colored.reserve(colorCode.size() + message.size() + resetCode.size());
+    colored += colorCode;
+    colored += message;
+    colored += resetCode;
+    return colored;
 }
 
-std::string ProjectPrinter::getColorCode(const std::string& color) const {
+const std::string& ProjectPrinter::getColorCode(const std::string& color) {
     // Map color names to ANSI color codes
-    std::unordered_map<std::string, std::string> colorMap = {
+    static const std::unordered_map<std::string, std::string> colorMap = {
         {"black", "\033[30m"},
         {"red", "\033[31m"},
         {"green", "\033[32m"},
@@ -143,77 +196,80 @@ std::string ProjectPrinter::getColorCode(const std::string& color) const {
         {"white", "\033[37m"}
     };
 
-    if (colorMap.find(color) != colorMap.end()) {
-        return colorMap[color];
+    static const std::string noColor;
+
+    auto it = colorMap.find(color);
+    if (it != colorMap.end()) {
+        return it->second;
     } else {
-        return ""; // Return an empty string for unknown colors
+        return noColor; // Return an empty string for unknown colors
     }
 }
 
 // Getters for configuration details
 std::string ProjectPrinter::getInfoColor() const {
-    return infoColor;
+    return settings->infoColor;
 }
 
 std::string ProjectPrinter::getWarningColor() const {
-    return warningColor;
+    return settings->warningColor;
 }
 
 std::string ProjectPrinter::getErrorColor() const {
-    return errorColor;
+    return settings->errorColor;
 }
 
 bool ProjectPrinter::shouldPrintLineNumber() const {
-    return printLineNumber;
+    return settings->printLineNumber;
 }
 
 std::string ProjectPrinter::getPrefix() const {
-    return prefix;
+    return settings->prefix;
 }
 
 std::string ProjectPrinter::getSuffix() const {
-    return suffix;
+    return settings->suffix;
 }
 
 bool ProjectPrinter::shouldPrintTime() const {
-    return printTime;
+    return settings->printTime;
 }
 
 
 nlohmann::json ProjectPrinter::getConfig() const {
-    return config;
+    return settings->config;
 }
 
 // Setters for configuration details
 void ProjectPrinter::setInfoColor(const std::string& color) {
-    infoColor = color;
+    EditSettings().infoColor = color;
 }
 
 void ProjectPrinter::setWarningColor(const std::string& color) {
-    warningColor = color;
+    EditSettings().warningColor = color;
 }
 
 void ProjectPrinter::setErrorColor(const std::string& color) {
-    errorColor = color;
+    EditSettings().errorColor = color;
 }
 
 void ProjectPrinter::setPrintLineNumber(bool printLineNum) {
-    printLineNumber = printLineNum;
+    EditSettings().printLineNumber = printLineNum;
 }
 
 void ProjectPrinter::setPrefix(const std::string& newPrefix) {
-    prefix = newPrefix;
+    EditSettings().prefix = newPrefix;
 }
 
 void ProjectPrinter::setSuffix(const std::string& newSuffix) {
-    suffix = newSuffix;
+    EditSettings().suffix = newSuffix;
 }
 
 void ProjectPrinter::setConfig(const nlohmann::json& newConfig) {
-    config = newConfig;
+    settings = SettingsFromConfig(newConfig);
 }
 
 void ProjectPrinter::setPrintTime(bool printTime) {
-    this->printTime = printTime;
+    EditSettings().printTime = printTime;
 }
 
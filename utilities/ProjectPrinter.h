@@ -2,6 +2,7 @@
 #define PROJECTPRINTER_H
 
 #include <string>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <chrono>
 #include <ctime>
@@ -11,6 +12,10 @@
  *
  * The `ProjectPrinter` class provides functionality to print messages with customizable colors,
  * prefixes, suffixes, and additional information such as line numbers and timestamps.
+ * @details Configuration files are read once per process and the parsed settings are shared
+ * by every printer, so constructing a printer is cheap. Setters copy the settings first, so
+ * they only affect the printer they are called on. While the \ref AsyncLogger runs, printed
+ * lines are handed to its background thread instead of being written to stdout directly.
  */
 class ProjectPrinter {
 public:
@@ -166,17 +171,51 @@ public:
 private:
     // ... Other private member functions ...
 
+    /**
+     * @brief Settings shared by every printer created from the same configuration.
+     */
+    struct Settings {
+        nlohmann::json config;          ///< JSON object for storing configuration settings.
+        std::string infoColor;          ///< Color code for information messages.
+        std::string warningColor;       ///< Color code for warning messages.
+        std::string errorColor;         ///< Color code for error messages.
+        bool printLineNumber = true;    ///< Flag indicating whether to print line numbers.
+        std::string prefix;             ///< Prefix for printed messages.
+        std::string suffix;             ///< Suffix for printed messages.
+        bool printTime = true;          ///< Flag indicating whether to print timestamps.
+    };
+
     /**
      * @brief Initializes the ProjectPrinter with the given configuration file.
      * @param configPath The path to the custom configuration file.
      */
     void Initialize(const std::string& configPath);
 
+    /**
+     * @brief Gets the settings of a configuration file, reading it only the first time.
+     * @param configPath The path to the configuration file.
+     * @return The shared settings.
+     */
+    static std::shared_ptr<const Settings> LoadSettings(const std::string& configPath);
+
+    /**
+     * @brief Builds settings from a parsed configuration.
+     * @param config The configuration as a JSON object.
+     * @return The settings.
+     */
+    static std::shared_ptr<const Settings> SettingsFromConfig(const nlohmann::json& config);
+
+    /**
+     * @brief Gets settings that only this printer uses, copying the shared ones if needed.
+     * @return Reference to the settings of this printer.
+     */
+    Settings& EditSettings();
+
     /**
      * @brief Gets the default path for the configuration file.
      * @return The default path for the configuration file.
      */
-    std::string getDefaultConfigPath() const;
+    static std::string getDefaultConfigPath();
 
     /**
      * @brief Builds the complete message string with color, prefix, suffix, and additional information.
@@ -201,7 +240,7 @@ private:
      * @param color The color identifier.
      * @return The ANSI color code.
      */
-    std::string getColorCode(const std::string& color) const;
+    static const std::string& getColorCode(const std::string& color);
 
     /**
      * @brief Gets the current time as a string.
@@ -209,14 +248,7 @@ private:
      */
     std::string getCurrentTime() const;
 
-    nlohmann::json config;          ///< JSON object for storing configuration settings.
-    std::string infoColor;          ///< Color code for information messages.
-    std::string warningColor;       ///< Color code for warning messages.
-    std::string errorColor;         ///< Color code for error messages.
-    bool printLineNumber;           ///< Flag indicating whether to print line numbers.
-    std::string prefix;             ///< Prefix for printed messages.
-    std::string suffix;             ///< Suffix for printed messages.
-    bool printTime;                 ///< Flag indicating whether to print timestamps.
+    std::shared_ptr<const Settings> settings; ///< Settings, shared until a setter is called.
 };
 
 #endif // PROJECTPRINTER_H
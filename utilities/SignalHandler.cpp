@@ -4,6 +4,8 @@
 SignalHandler::SignalHandler() {
     // Initialize the flag indicating whether a quit signal is received
     quitSignalReceived.store(false);
+    traceDumpRequested.store(false);
+    reloadRequested.store(false);
 
     // Register signal handlers in the constructor
     registerSignalHandlers();
@@ -14,6 +16,7 @@ SignalHandler::~SignalHandler() {
     signal(SIGINT, SIG_DFL);
     signal(SIGHUP, SIG_DFL);
     signal(SIGTERM, SIG_DFL);
+    signal(SIGUSR1, SIG_DFL);
 }
 
 
@@ -28,6 +31,34 @@ bool SignalHandler::isQuitSignalReceived() const {
     return quitSignalReceived.load();
 }
 
+void SignalHandler::enableReloadSignal() {
+    signal(SIGHUP, handleReloadSignal);
+}
+
+bool SignalHandler::takeReloadRequest() {
+    return reloadRequested.exchange(false);
+}
+
+void SignalHandler::enableTraceDumpSignal() {
+    signal(SIGUSR1, handleTraceDumpSignal);
+}
+
+bool SignalHandler::takeTraceDumpRequest() {
+    return traceDumpRequested.exchange(false);
+}
+
+void SignalHandler::handleTraceDumpSignal(int signal) {
+    if (signal == SIGUSR1) {
+        getInstance().traceDumpRequested.store(true);
+    }
+}
+
+void SignalHandler::handleReloadSignal(int signal) {
+    if (signal == SIGHUP) {
+        getInstance().reloadRequested.store(true);
+    }
+}
+
 void SignalHandler::handleQuitSignal(int signal) {
     if (signal == SIGINT || signal == SIGHUP || signal == SIGTERM) {
         getInstance().quitSignalReceived.store(true);
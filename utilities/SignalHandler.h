@@ -29,6 +29,29 @@ public:
      */
     bool isQuitSignalReceived() const;
 
+    /**
+     * @brief Makes SIGHUP request a configuration reload instead of ending the program.
+     */
+    void enableReloadSignal();
+
+    /**
+     * @brief Checks whether a configuration reload was requested and clears the request.
+     * @return True if SIGHUP was received since the last call, false otherwise.
+     */
+    bool takeReloadRequest();
+
+    /**
+     * @brief Makes SIGUSR1 request a trace dump instead of ending the program.
+     * @see TraceRecorder
+     */
+    void enableTraceDumpSignal();
+
+    /**
+     * @brief Checks whether a trace dump was requested and clears the request.
+     * @return True if SIGUSR1 was received since the last call, false otherwise.
+     */
+    bool takeTraceDumpRequest();
+
     /**
      * @brief Static function to get the singleton instance of SignalHandler.
      * @return Reference to the singleton instance.
@@ -37,6 +60,8 @@ public:
 
 private:
     std::atomic<bool> quitSignalReceived;  ///< Atomic flag indicating whether a quit signal is received.
+    std::atomic<bool> traceDumpRequested;  ///< Atomic flag indicating whether a trace dump was requested.
+    std::atomic<bool> reloadRequested;     ///< Atomic flag indicating whether a configuration reload was requested.
 
     /**
      * @brief Registers signal handlers during construction.
@@ -48,6 +73,18 @@ private:
      * @param signal The signal number.
      */
     static void handleQuitSignal(int signal);
+
+    /**
+     * @brief Static function to handle trace dump requests (SIGUSR1).
+     * @param signal The signal number.
+     */
+    static void handleTraceDumpSignal(int signal);
+
+    /**
+     * @brief Static function to handle configuration reload requests (SIGHUP).
+     * @param signal The signal number.
+     */
+    static void handleReloadSignal(int signal);
 };
 
 #endif // SIGNALHANDLER_H
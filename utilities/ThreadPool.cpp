@@ -0,0 +1,120 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t numThreads)
+    : nextQueue(0), queuedTasks(0), unfinishedTasks(0), stopping(false) {
+    numThreads = std::max<size_t>(numThreads, 1);
+    for (size_t i = 0; i < numThreads; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < numThreads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    unfinishedTasks++;
+    WorkerQueue& queue = *queues[nextQueue.fetch_add(1) % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+        queuedTasks++;
+    }
+    {
+        // Taking the lock orders the notification with a worker that is about to sleep
+        std::lock_guard<std::mutex> lock(stateMutex);
+        workAvailable.notify_one();
+    }
+}
+
+void ThreadPool::waitIdle() {
+    // Help out instead of just blocking
+    std::function<void()> task;
+    while (takeTask(0, task)) {
+        runTask(task);
+    }
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allFinished.wait(lock, [this]() { return unfinishedTasks.load() == 0; });
+
+    if (firstException) {
+        std::exception_ptr exception = firstException;
+        firstException = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+size_t ThreadPool::getThreadCount() const {
+    return workers.size();
+}
+
+bool ThreadPool::takeTask(size_t index, std::function<void()>& task) {
+    // Newest task of the own queue first, it is the most likely to be cache hot
+    {
+        WorkerQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queuedTasks--;
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another queue
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkerQueue& other = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            queuedTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(std::function<void()>& task) {
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!firstException) {
+            firstException = std::current_exception();
+        }
+    }
+    task = nullptr;
+
+    if (unfinishedTasks.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        allFinished.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    std::function<void()> task;
+    while (true) {
+        if (takeTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this]() { return stopping || queuedTasks.load() > 0; });
+        if (stopping && queuedTasks.load() == 0) {
+            return;
+        }
+    }
+}
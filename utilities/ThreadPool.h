@@ -0,0 +1,98 @@
+// ThreadPool.h
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+/**
+ * @brief A fixed size work-stealing thread pool.
+ *
+ * The `ThreadPool` class gives every worker its own task queue. Submitted tasks are spread
+ * over the queues round robin, workers take tasks from the back of their own queue and steal
+ * from the front of the others when it runs dry, so uneven tasks still keep every worker busy.
+ * The thread waiting in \ref waitIdle runs tasks as well instead of just blocking.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructor for ThreadPool.
+     * @param numThreads Number of worker threads to start (at least 1).
+     */
+    explicit ThreadPool(size_t numThreads);
+
+    /**
+     * @brief Destructor for ThreadPool. Finishes the queued tasks and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task to run on the pool.
+     * @param task The task to run.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Runs queued tasks on the calling thread until every submitted task has finished.
+     * @throws The first exception thrown by a task since the last call, after all tasks finished.
+     */
+    void waitIdle();
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The number of worker threads.
+     */
+    size_t getThreadCount() const;
+
+private:
+    /**
+     * @brief The task queue of one worker.
+     */
+    struct WorkerQueue {
+        std::mutex mutex;                         ///< Protects the tasks.
+        std::deque<std::function<void()>> tasks;  ///< Tasks waiting to run.
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues; ///< One task queue per worker.
+    std::vector<std::thread> workers; ///< The worker threads.
+    std::atomic<size_t> nextQueue; ///< Queue that receives the next submitted task.
+    std::atomic<size_t> queuedTasks; ///< Tasks waiting in any queue.
+    std::atomic<size_t> unfinishedTasks; ///< Tasks submitted but not finished yet.
+    bool stopping; ///< Flag telling the workers to exit once the queues are empty.
+    std::mutex stateMutex; ///< Protects stopping, firstException and the condition variables.
+    std::condition_variable workAvailable; ///< Signalled when a task is submitted or the pool stops.
+    std::condition_variable allFinished; ///< Signalled when the last unfinished task finishes.
+    std::exception_ptr firstException; ///< First exception thrown by a task since the last waitIdle.
+
+    /**
+     * @brief Takes a task, preferring the given queue and stealing from the others.
+     * @param index The queue to look at first.
+     * @param task Receives the task.
+     * @return True if a task was taken, false if every queue was empty.
+     */
+    bool takeTask(size_t index, std::function<void()>& task);
+
+    /**
+     * @brief Runs a task and records its completion.
+     * @param task The task to run.
+     */
+    void runTask(std::function<void()>& task);
+
+    /**
+     * @brief Runs tasks until the pool stops.
+     * @param index The worker's own queue.
+     */
+    void workerLoop(size_t index);
+};
+
+#endif // THREADPOOL_H
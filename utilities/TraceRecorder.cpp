@@ -0,0 +1,98 @@
+#include "TraceRecorder.h"
+#include "MessageHeader.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <algorithm>
+#include <unistd.h>
+
+TraceRecorder::TraceRecorder() : enabled(false), nextSlot(0), recordedCount(0) {
+}
+
+TraceRecorder& TraceRecorder::Instance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+void TraceRecorder::enable(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ring.assign(std::max<size_t>(capacity, 1), Span());
+    nextSlot = 0;
+    recordedCount = 0;
+    enabled.store(true);
+}
+
+uint32_t TraceRecorder::getThreadId() {
+    static std::atomic<uint32_t> nextThreadId(1);
+    thread_local uint32_t threadId = nextThreadId++;
+    return threadId;
+}
+
+void TraceRecorder::record(const char* name, const char* category, const std::string& detail, uint64_t startNs, uint64_t endNs) {
+    uint32_t threadId = getThreadId();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ring.empty()) {
+        return;
+    }
+    Span& span = ring[nextSlot];
+    span.name = name;
+    span.category = category;
+    span.detail = detail; // Reuses the slot's capacity once the ring has wrapped
+    span.startNs = startNs;
+    span.durationNs = endNs - startNs;
+    span.threadId = threadId;
+    nextSlot = (nextSlot + 1) % ring.size();
+    recordedCount++;
+}
+
+bool TraceRecorder::dump(const std::string& path) const {
+    // Copy under the lock, format without it so recording threads are not held up
+    std::vector<Span> spans;
+    size_t overwritten;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t kept = std::min(recordedCount, ring.size());
+        overwritten = recordedCount - kept;
+        size_t first = (nextSlot + ring.size() - kept) % std::max<size_t>(ring.size(), 1);
+        spans.reserve(kept);
+        for (size_t i = 0; i < kept; ++i) {
+            spans.push_back(ring[(first + i) % ring.size()]);
+        }
+    }
+
+    int pid = static_cast<int>(getpid());
+    nlohmann::json events = nlohmann::json::array();
+    for (const Span& span : spans) {
+        nlohmann::json event = {
+            {"name", span.name}, {"cat", span.category}, {"ph", "X"}, {"pid", pid}, {"tid", span.threadId},
+            {"ts", span.startNs / 1000.0}, {"dur", span.durationNs / 1000.0}
+        };
+        if (!span.detail.empty()) {
+            event["args"] = {{"detail", span.detail}};
+        }
+        events.push_back(std::move(event));
+    }
+    nlohmann::json trace = {
+        {"traceEvents", std::move(events)},
+        {"displayTimeUnit", "ms"},
+        {"otherData", {{"overwrittenSpans", overwritten}, {"dumpWallTimeNs", MessageHeader::WallNowNs()}}}
+    };
+
+    std::ofstream file(path);
+    file << trace.dump() << std::endl;
+    return static_cast<bool>(file);
+}
+
+TraceScope::TraceScope(const char* name, const char* category, const std::string& detail)
+    : name(nullptr), category(category), startNs(0) {
+    if (TraceRecorder::Instance().isEnabled()) {
+        this->name = name;
+        this->detail = detail;
+        startNs = MessageHeader::MonotonicNowNs();
+    }
+}
+
+TraceScope::~TraceScope() {
+    if (name) {
+        TraceRecorder::Instance().record(name, category, detail, startNs, MessageHeader::MonotonicNowNs());
+    }
+}
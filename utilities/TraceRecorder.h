@@ -0,0 +1,120 @@
+// TraceRecorder.h
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Records what the publisher was doing into an in-memory ring for timeline analysis.
+ *
+ * The `TraceRecorder` class is a singleton flight recorder. While enabled, spans of the main
+ * loop, the processors, serialization and socket sends are kept in a fixed size ring, the
+ * oldest being overwritten, and can be written at any time as Chrome trace JSON, which
+ * chrome://tracing and Perfetto open directly.
+ * @details Each span is stored as one complete event ("ph": "X") holding both its begin and
+ * its duration. When disabled, recording costs one relaxed atomic load, see \ref TraceScope.
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief Gets the singleton instance of TraceRecorder.
+     * @return Reference to the singleton instance.
+     */
+    static TraceRecorder& Instance();
+
+    /**
+     * @brief Starts recording.
+     * @param capacity Number of spans the ring keeps.
+     */
+    void enable(size_t capacity);
+
+    /**
+     * @brief Checks if spans are recorded.
+     * @return True if recording, false otherwise.
+     */
+    bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records a finished span.
+     * @param name Name of the span, must be a string literal.
+     * @param category Category of the span, must be a string literal.
+     * @param detail Shown as the span's "detail" argument, for example the channel, empty for none.
+     * @param startNs Monotonic time the span began, in ns.
+     * @param endNs Monotonic time the span ended, in ns.
+     */
+    void record(const char* name, const char* category, const std::string& detail, uint64_t startNs, uint64_t endNs);
+
+    /**
+     * @brief Writes the recorded spans as Chrome trace JSON.
+     * @param path The file to write.
+     * @return True if written, false otherwise.
+     * @details The ring is kept, so later dumps contain the same spans plus the new ones.
+     */
+    bool dump(const std::string& path) const;
+
+private:
+    /**
+     * @brief Private constructor for TraceRecorder.
+     */
+    TraceRecorder();
+
+    /**
+     * @brief One recorded span.
+     */
+    struct Span {
+        const char* name = nullptr;     ///< Name of the span.
+        const char* category = nullptr; ///< Category of the span.
+        std::string detail;             ///< Detail argument, empty for none.
+        uint64_t startNs = 0;           ///< Monotonic begin time in ns.
+        uint64_t durationNs = 0;        ///< Duration in ns.
+        uint32_t threadId = 0;          ///< Small number identifying the recording thread.
+    };
+
+    /**
+     * @brief Gets the number of the calling thread in the trace.
+     * @return The thread's number, assigned on first use.
+     */
+    static uint32_t getThreadId();
+
+    std::atomic<bool> enabled; ///< Flag indicating spans are recorded.
+    mutable std::mutex mutex; ///< Guards the ring, spans are short and rare compared to the work they describe.
+    std::vector<Span> ring; ///< The recorded spans, reused in place.
+    size_t nextSlot; ///< Slot the next span is written to.
+    size_t recordedCount; ///< Spans recorded in total.
+};
+
+/**
+ * @brief Records the lifetime of a scope as a span when tracing is enabled.
+ */
+class TraceScope {
+public:
+    /**
+     * @brief Begins the span.
+     * @param name Name of the span, must be a string literal.
+     * @param category Category of the span, must be a string literal.
+     * @param detail Detail argument, for example the channel, empty for none.
+     */
+    TraceScope(const char* name, const char* category, const std::string& detail = "");
+
+    /**
+     * @brief Ends and records the span.
+     */
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;     ///< Name of the span, null if tracing was disabled at the start.
+    const char* category; ///< Category of the span.
+    std::string detail;   ///< Detail argument, only copied while tracing.
+    uint64_t startNs;     ///< Monotonic time the span began.
+};
+
+#endif // TRACERECORDER_H